@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <periodic_function/debounce.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+/**
+ * @brief Cost of notify() on the hot path of a debouncer and a throttler.
+ * @details Every thread calls notify() in a tight loop while the quiet period (or interval) is
+ * longer than the run, so only the first call arms the timer and all others take the lock free
+ * path. Reported is the wall time per call and thread, for one thread and for one thread per
+ * hardware thread. A debouncer notify() reads the clock, so the cost of steady_clock::now() is
+ * shown for reference.
+ */
+namespace {
+  constexpr std::uint64_t iterations = 10'000'000;
+
+  template <typename Notify> double nanoseconds_per_call(std::size_t threads, Notify notify) {
+    std::atomic<std::size_t> ready{0};
+    std::vector<std::thread> workers;
+    std::vector<double> results(threads);
+    for (std::size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t]() {
+        ++ready;
+        while (ready.load() != threads) {
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for (std::uint64_t i = 0; i < iterations; ++i) notify();
+        results[t] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now()
+                                                              - start)
+                         .count()
+                     / static_cast<double>(iterations);
+      });
+    }
+    for (auto &worker : workers) worker.join();
+    return *std::max_element(results.begin(), results.end());
+  }
+}  // namespace
+
+int main() {
+  dp::scheduler scheduler;
+  std::atomic<int> calls{0};
+  dp::debouncer debounce(scheduler, [&calls]() { ++calls; }, 1h);
+  dp::throttler throttle(scheduler, [&calls]() { ++calls; }, 1h);
+
+  const auto max_threads = std::max(1U, std::thread::hardware_concurrency());
+  for (const std::size_t threads : {std::size_t{1}, std::size_t{max_threads}}) {
+    std::cout << threads << " thread(s):\n";
+    std::atomic<std::int64_t> clock_sink{0};
+    const auto read_clock = [&clock_sink]() {
+      const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+      clock_sink.store(now, std::memory_order_relaxed);
+    };
+    std::cout << "  steady_clock::now(): " << nanoseconds_per_call(threads, read_clock)
+              << " ns/call\n";
+    std::cout << "  debouncer::notify(): "
+              << nanoseconds_per_call(threads, [&debounce]() { debounce.notify(); })
+              << " ns/call\n";
+    std::cout << "  throttler::notify(): "
+              << nanoseconds_per_call(threads, [&throttle]() { throttle.notify(); })
+              << " ns/call\n";
+    if (max_threads == 1) break;
+  }
+  return 0;
+}
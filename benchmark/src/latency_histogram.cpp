@@ -0,0 +1,52 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <periodic_function/latency_histogram.hpp>
+#include <thread>
+#include <vector>
+
+namespace {
+  constexpr std::uint64_t iterations = 100'000'000;
+
+  /**
+   * @brief Time record() for values spread over several power of two ranges.
+   * @details The values come from a cheap linear congruential generator so the bucket index
+   * cannot be hoisted out of the loop.
+   */
+  double time_per_record(dp::latency_histogram &histogram, std::uint64_t seed) {
+    auto value = seed;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+      histogram.record_value(value >> 44U);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count()
+           / static_cast<double>(iterations);
+  }
+}  // namespace
+
+int main() {
+  dp::latency_histogram histogram;
+  std::cout << "single writer: " << time_per_record(histogram, 1) << " ns/record\n";
+
+  // shared histogram, as when several timers record into the same stats
+  histogram.reset();
+  constexpr unsigned writers = 4;
+  std::vector<std::thread> threads;
+  std::vector<double> results(writers);
+  for (unsigned t = 0; t < writers; ++t) {
+    threads.emplace_back([&histogram, &results, t]() {
+      results[t] = time_per_record(histogram, t + 1U);
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  for (unsigned t = 0; t < writers; ++t) {
+    std::cout << "shared writer " << t << ": " << results[t] << " ns/record\n";
+  }
+  std::cout << "p50 " << histogram.percentile(50.0).count() << "ns, p99 "
+            << histogram.percentile(99.0).count() << "ns, serialized "
+            << histogram.serialize().size() << " bytes\n";
+  return 0;
+}
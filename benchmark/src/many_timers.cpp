@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <periodic_function/latency_histogram.hpp>
+#include <periodic_function/periodic_function.hpp>
+#include <periodic_function/scheduler.hpp>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <sys/resource.h>
+#endif
+
+using namespace std::chrono_literals;
+
+/**
+ * @brief Compare execution models for many timers: one thread per periodic_function, a single
+ * shared scheduler, and one scheduler per hardware thread with timers spread round robin.
+ * @details For 10, 100, 1k and 10k timers with a 100ms interval, reports resident memory and
+ * thread count while running, context switches and CPU use (from getrusage) over the measured
+ * window, and wakeup lateness percentiles of all ticks.
+ * Usage: many_timers [seconds per run] [maximum number of timers]
+ */
+namespace {
+  constexpr auto interval = 100ms;
+
+  struct usage {
+    std::chrono::microseconds cpu{0};
+    long context_switches{0};
+  };
+
+  usage process_usage() {
+    usage result{};
+#if defined(__unix__) || defined(__APPLE__)
+    rusage self{};
+    if (getrusage(RUSAGE_SELF, &self) == 0) {
+      const auto to_duration = [](const timeval &time) {
+        return std::chrono::seconds{time.tv_sec} + std::chrono::microseconds{time.tv_usec};
+      };
+      result.cpu = to_duration(self.ru_utime) + to_duration(self.ru_stime);
+      result.context_switches = self.ru_nvcsw + self.ru_nivcsw;
+    }
+#endif
+    return result;
+  }
+
+  /// @brief A field of /proc/self/status (e.g. VmRSS in kB, Threads), -1 where unavailable.
+  long proc_status(const std::string &field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+      if (line.compare(0, field.size() + 1, field + ":") == 0) {
+        return std::strtol(line.c_str() + field.size() + 1, nullptr, 10);
+      }
+    }
+    return -1;
+  }
+
+  struct result {
+    long rss_kb{-1};
+    long threads{-1};
+    long context_switches{0};
+    double cpu_percent{0.0};
+    dp::latency_histogram lateness{};
+  };
+
+  /**
+   * @brief Measure a running set of timers.
+   * @param start registers and starts the timers, recording lateness into the histogram.
+   * @param stop stops and destroys them.
+   */
+  void measure(const std::string &model, std::size_t timers, std::chrono::seconds duration,
+               const std::function<void(dp::latency_histogram &)> &start,
+               const std::function<void()> &stop) {
+    result measured{};
+    try {
+      start(measured.lateness);
+    } catch (const std::system_error &error) {
+      stop();
+      std::cout << std::setw(14) << model << std::setw(8) << timers
+                << "  failed to start: " << error.what() << '\n';
+      return;
+    }
+    // let every timer tick once before measuring
+    std::this_thread::sleep_for(interval * 2);
+    measured.lateness.reset();
+    const auto before = process_usage();
+    const auto wall_start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(duration);
+    const auto after = process_usage();
+    const auto wall = std::chrono::steady_clock::now() - wall_start;
+    measured.rss_kb = proc_status("VmRSS");
+    measured.threads = proc_status("Threads");
+    stop();
+
+    measured.context_switches = after.context_switches - before.context_switches;
+    measured.cpu_percent = 100.0 * std::chrono::duration<double>(after.cpu - before.cpu).count()
+                           / std::chrono::duration<double>(wall).count();
+    const auto micros = [&measured](double percent) {
+      return std::chrono::duration<double, std::micro>(measured.lateness.percentile(percent))
+          .count();
+    };
+    std::cout << std::setw(14) << model << std::setw(8) << timers << std::setw(10)
+              << measured.rss_kb << std::setw(9) << measured.threads << std::setw(11)
+              << measured.context_switches << std::fixed << std::setprecision(1) << std::setw(8)
+              << measured.cpu_percent << std::setw(10) << micros(50.0) << std::setw(10)
+              << micros(99.0) << std::setw(10) << micros(100.0) << '\n';
+  }
+
+  void thread_per_timer(std::size_t count, std::chrono::seconds duration) {
+    std::vector<std::unique_ptr<dp::periodic_function<std::function<void(const dp::tick_info &)>>>>
+        timers;
+    measure(
+        "thread/timer", count, duration,
+        [&timers, count](dp::latency_histogram &lateness) {
+          timers.reserve(count);
+          for (std::size_t i = 0; i < count; ++i) {
+            timers.push_back(
+                std::make_unique<
+                    dp::periodic_function<std::function<void(const dp::tick_info &)>>>(
+                    [&lateness](const dp::tick_info &info) {
+                      lateness.record(info.start_time - info.scheduled_time);
+                    },
+                    interval));
+            timers.back()->start();
+          }
+        },
+        [&timers]() { timers.clear(); });
+  }
+
+  void sharded_schedulers(const std::string &model, std::size_t shards, std::size_t count,
+                          std::chrono::seconds duration) {
+    std::vector<std::unique_ptr<dp::scheduler>> schedulers;
+    measure(
+        model, count, duration,
+        [&schedulers, shards, count](dp::latency_histogram &lateness) {
+          for (std::size_t i = 0; i < shards; ++i) {
+            schedulers.push_back(std::make_unique<dp::scheduler>());
+          }
+          for (std::size_t i = 0; i < count; ++i) {
+            schedulers[i % shards]->add_timer(
+                [&lateness](const dp::tick_info &info) {
+                  lateness.record(info.start_time - info.scheduled_time);
+                },
+                interval);
+          }
+        },
+        [&schedulers]() { schedulers.clear(); });
+  }
+}  // namespace
+
+int main(int argc, char **argv) {
+  // rows are printed as each run finishes
+  std::cout << std::unitbuf;
+  const std::chrono::seconds duration{argc > 1 ? std::strtol(argv[1], nullptr, 10) : 2};
+  const auto max_timers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10'000UL;
+  const auto shards = std::max(1U, std::thread::hardware_concurrency());
+
+  std::cout << std::setw(14) << "model" << std::setw(8) << "timers" << std::setw(10) << "rss_kb"
+            << std::setw(9) << "threads" << std::setw(11) << "ctx_switch" << std::setw(8)
+            << "cpu_%" << std::setw(10) << "p50_us" << std::setw(10) << "p99_us" << std::setw(10)
+            << "max_us" << '\n';
+  for (const std::size_t count : {10U, 100U, 1'000U, 10'000U}) {
+    if (count > max_timers) break;
+    thread_per_timer(count, duration);
+    sharded_schedulers("scheduler", 1, count, duration);
+    if (shards > 1) {
+      sharded_schedulers("scheduler x" + std::to_string(shards), shards, count, duration);
+    }
+  }
+  return 0;
+}
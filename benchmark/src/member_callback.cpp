@@ -0,0 +1,67 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <periodic_function/periodic_function.hpp>
+#include <string>
+
+namespace {
+  struct counter {
+    std::uint64_t count{0};
+    void on_timeout() { ++count; }
+  };
+
+  /**
+   * @brief Make @p value observable and unknown to the optimizer, so the work done on it in one
+   * iteration can neither be dropped nor merged with the next.
+   */
+  template <typename T> void clobber(T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    // keeps the compiler from reordering or merging memory accesses across the fence
+    static_cast<void>(&value);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+  }
+
+  /**
+   * @brief Time the call path the timer loop uses for every tick (details::invoke_callback).
+   * @details The target counter is clobbered after every call, so each increment really
+   * happens even when the call is fully inlined and the loop cannot be folded away.
+   */
+  template <typename Callback>
+  void run(const std::string &name, Callback callback, counter &target) {
+    constexpr std::uint64_t iterations = 100'000'000;
+    const dp::tick_info info{};
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      dp::details::invoke_callback(callback, info);
+      clobber(target);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto per_call = std::chrono::duration<double, std::nano>(elapsed).count()
+                          / static_cast<double>(iterations);
+    std::cout << name << ": " << per_call << " ns/call (count " << target.count << ")\n";
+  }
+}  // namespace
+
+int main() {
+  counter bind_target{};
+  run("std::bind", std::bind(&counter::on_timeout, &bind_target), bind_target);
+
+  counter function_target{};
+  run("std::function(std::bind)",
+      std::function<void()>(std::bind(&counter::on_timeout, &function_target)), function_target);
+
+  counter pointer_target{};
+  run("member function pointer",
+      dp::details::member_function_callback<void (counter::*)(), counter>(&counter::on_timeout,
+                                                                          &pointer_target),
+      pointer_target);
+
+  counter bound_target{};
+  run("dp::bind_member", dp::bind_member<&counter::on_timeout>(bound_target), bound_target);
+  return 0;
+}
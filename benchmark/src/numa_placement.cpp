@@ -0,0 +1,66 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <periodic_function/latency_histogram.hpp>
+#include <periodic_function/numa.hpp>
+#include <periodic_function/periodic_function.hpp>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+/**
+ * @brief Cost of a memory heavy periodic job depending on where its data and its timer thread
+ * are placed.
+ * @details For every pair of NUMA nodes, a 64MiB buffer is placed on the data node with a
+ * dp::numa_arena and a timer bound to the runner node sums it on every tick. Reports the median
+ * callback time; the off-diagonal entries show the cost of cross-socket traffic, which node
+ * hints avoid. On a single node host there is only the one entry.
+ */
+namespace {
+  constexpr std::size_t buffer_size = 64U << 20U;
+
+  std::chrono::nanoseconds median_tick(int data_node, int runner_node) {
+    dp::numa_arena arena(buffer_size, data_node);
+    auto *data = static_cast<std::uint64_t *>(arena.allocate(buffer_size, 64));
+    const auto words = buffer_size / sizeof(std::uint64_t);
+    for (std::size_t i = 0; i < words; ++i) data[i] = i;
+
+    // keeps the sum observable so the loop is not optimized away
+    std::atomic<std::uint64_t> sink{0};
+    dp::timer_stats stats;
+    dp::periodic_function<std::function<void()>> job(
+        [&]() {
+          std::uint64_t sum = 0;
+          for (std::size_t i = 0; i < words; i += 8) sum += data[i];
+          sink.fetch_add(sum, std::memory_order_relaxed);
+        },
+        50ms);
+    job.set_numa_node(runner_node);
+    job.attach_stats(&stats);
+    job.start();
+    std::this_thread::sleep_for(1s);
+    job.stop();
+    return stats.execution.percentile(50.0);
+  }
+}  // namespace
+
+int main() {
+  const auto nodes = dp::numa_node_count();
+  std::cout << "median ms per tick, rows: data node, columns: runner node\n     ";
+  for (int runner = 0; runner < nodes; ++runner) std::cout << std::setw(10) << runner;
+  std::cout << '\n';
+  for (int data = 0; data < nodes; ++data) {
+    std::cout << std::setw(5) << data;
+    for (int runner = 0; runner < nodes; ++runner) {
+      const auto tick = std::chrono::duration<double, std::milli>(median_tick(data, runner));
+      std::cout << std::setw(10) << std::fixed << std::setprecision(2) << tick.count()
+                << std::flush;
+    }
+    std::cout << '\n';
+  }
+  return 0;
+}
@@ -0,0 +1,51 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <periodic_function/scheduler.hpp>
+
+using namespace std::chrono_literals;
+
+/**
+ * @brief Cost of polling a scheduler from a busy loop.
+ * @details run_due() with nothing due only compares against the cached earliest deadline;
+ * poll() adds a read of the steady clock. The loop then runs with a 1ms timer to show the cost
+ * of the iterations that do dispatch.
+ */
+namespace {
+  constexpr std::uint64_t iterations = 100'000'000;
+
+  double nanoseconds_per_call(std::chrono::steady_clock::duration elapsed) {
+    return std::chrono::duration<double, std::nano>(elapsed).count()
+           / static_cast<double>(iterations);
+  }
+}  // namespace
+
+int main() {
+  dp::scheduler_options options;
+  options.polling = true;
+  dp::scheduler scheduler(options);
+  std::uint64_t ticks = 0;
+  scheduler.add_timer([&ticks]() { ++ticks; }, 1h);
+
+  const auto now = dp::scheduler::clock_type::now();
+  std::size_t dispatched = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (std::uint64_t i = 0; i < iterations; ++i) dispatched += scheduler.run_due(now);
+  std::cout << "run_due(now), nothing due: "
+            << nanoseconds_per_call(std::chrono::steady_clock::now() - start) << " ns/call\n";
+
+  start = std::chrono::steady_clock::now();
+  for (std::uint64_t i = 0; i < iterations; ++i) dispatched += scheduler.poll();
+  std::cout << "poll(), nothing due: "
+            << nanoseconds_per_call(std::chrono::steady_clock::now() - start) << " ns/call\n";
+
+  scheduler.add_timer([&ticks]() { ++ticks; }, 1ms);
+  start = std::chrono::steady_clock::now();
+  for (std::uint64_t i = 0; i < iterations; ++i) dispatched += scheduler.poll();
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "poll() with a 1ms timer: " << nanoseconds_per_call(elapsed) << " ns/call, "
+            << dispatched << " ticks in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms\n";
+  return ticks == dispatched ? 0 : 1;
+}
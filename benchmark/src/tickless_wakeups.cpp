@@ -0,0 +1,45 @@
+#include <chrono>
+#include <iostream>
+#include <periodic_function/scheduler.hpp>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+int main() {
+  constexpr auto idle_time = 1s;
+  constexpr auto busy_time = 2s;
+
+  {
+    dp::scheduler scheduler;
+    std::this_thread::sleep_for(idle_time);
+    std::cout << "idle: " << scheduler.stats().wakeups << " wakeups in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(idle_time).count()
+              << " ms\n";
+  }
+
+  const std::vector<std::chrono::milliseconds> intervals{10ms, 25ms, 40ms, 100ms};
+  dp::scheduler scheduler;
+  // timers are registered microseconds apart, so deadlines that share a multiple of their
+  // intervals are served by a single wakeup. The minimum is the number of distinct instants.
+  std::set<std::chrono::milliseconds> instants;
+  for (const auto &interval : intervals) {
+    scheduler.add_timer([]() {}, interval);
+    for (auto deadline = interval; deadline <= busy_time; deadline += interval) {
+      instants.insert(deadline);
+    }
+  }
+  std::this_thread::sleep_for(busy_time);
+
+  const auto stats = scheduler.stats();
+  const auto seconds = std::chrono::duration<double>(busy_time).count();
+  std::cout << "timers:";
+  for (const auto &interval : intervals) std::cout << ' ' << interval.count() << "ms";
+  std::cout << "\n  wakeups/s: " << static_cast<double>(stats.wakeups) / seconds
+            << "\n  theoretical minimum wakeups/s: "
+            << static_cast<double>(instants.size()) / seconds
+            << "\n  dispatched/s: "
+            << static_cast<double>(stats[dp::priority::normal].dispatched) / seconds << '\n';
+  return 0;
+}
@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <periodic_function/latency_histogram.hpp>
+#include <periodic_function/periodic_function.hpp>
+#include <periodic_function/scheduler.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+/**
+ * @brief Timing regression gate.
+ * @details Measures wakeup lateness, per-tick overhead of the timer loop and startup time for
+ * many timers, and compares the results against a committed JSON baseline. Every metric is
+ * "lower is better" and fails when it exceeds its baseline by more than its tolerance, given as
+ * a fraction of the baseline. Each metric is the best of several repetitions, which keeps the
+ * gate stable on a noisy host while still catching changes that make the loop slower.
+ *
+ * Usage:
+ *   timing_gate                        print the measured metrics as JSON
+ *   timing_gate --baseline <file>      compare against a baseline, exit code 1 on a regression
+ *   timing_gate --write-baseline <file> [--tolerance <fraction>]
+ *                                      record a new baseline, with the default tolerance of
+ *                                      each metric unless --tolerance is given
+ */
+namespace {
+  constexpr int repetitions = 5;
+
+  struct metric {
+    double value{0.0};
+    double tolerance{0.0};
+  };
+
+  using metrics = std::map<std::string, metric>;
+
+  double to_microseconds(std::chrono::nanoseconds value) {
+    return std::chrono::duration<double, std::micro>(value).count();
+  }
+
+  /// @brief p50 and p99 wakeup lateness of a 1ms timer.
+  std::pair<double, double> measure_lateness() {
+    dp::timer_stats stats;
+    dp::periodic_function timer([]() {}, 1ms);
+    timer.attach_stats(&stats);
+    timer.start();
+    std::this_thread::sleep_for(300ms);
+    timer.stop();
+    return {to_microseconds(stats.lateness.percentile(50.0)),
+            to_microseconds(stats.lateness.percentile(99.0))};
+  }
+
+  /// @brief Time per tick of the timer loop with an empty callback that is always overdue.
+  double measure_tick_overhead() {
+    std::uint64_t ticks = 0;
+    dp::periodic_function timer([&ticks]() { ++ticks; }, 1ns);
+    const auto start = std::chrono::steady_clock::now();
+    timer.start();
+    std::this_thread::sleep_for(100ms);
+    timer.stop();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count()
+           / static_cast<double>(std::max<std::uint64_t>(ticks, 1));
+  }
+
+  /// @brief Time to start 64 thread per timer periodic functions.
+  double measure_thread_startup() {
+    constexpr std::size_t count = 64;
+    std::vector<std::unique_ptr<dp::periodic_function<std::function<void()>>>> timers;
+    timers.reserve(count);
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < count; ++i) {
+      timers.push_back(
+          std::make_unique<dp::periodic_function<std::function<void()>>>([]() {}, 1s));
+      timers.back()->start();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return to_microseconds(elapsed);
+  }
+
+  /// @brief Time to register 10k timers with a scheduler.
+  double measure_scheduler_startup() {
+    constexpr std::size_t count = 10'000;
+    dp::scheduler scheduler;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < count; ++i) scheduler.add_timer([]() {}, 1h);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return to_microseconds(elapsed);
+  }
+
+  metrics measure() {
+    metrics best;
+    // tolerances are tight enough to catch a doubling of any metric; tail latency and thread
+    // creation depend most on the host's load, so they get somewhat more slack
+    const auto keep_best = [&best](const std::string &name, double value, double tolerance) {
+      auto [it, inserted] = best.emplace(name, metric{value, tolerance});
+      if (!inserted) it->second.value = std::min(it->second.value, value);
+    };
+    for (int i = 0; i < repetitions; ++i) {
+      const auto [p50, p99] = measure_lateness();
+      keep_best("lateness_p50_us", p50, 0.5);
+      keep_best("lateness_p99_us", p99, 1.0);
+      keep_best("tick_overhead_ns", measure_tick_overhead(), 0.5);
+      keep_best("startup_64_threads_us", measure_thread_startup(), 1.0);
+      keep_best("startup_10k_scheduler_timers_us", measure_scheduler_startup(), 0.5);
+    }
+    return best;
+  }
+
+  /**
+   * @brief Reads the flat baseline format written by write_json(), without a JSON library:
+   * <tt>{"metrics": {"name": {"value": 1.0, "tolerance": 0.5}, ...}}</tt>.
+   */
+  class baseline_reader {
+  public:
+    explicit baseline_reader(std::string text) : text_(std::move(text)) {}
+
+    metrics read() {
+      metrics result;
+      expect('{');
+      while (peek() != '}') {
+        const auto section = read_string();
+        expect(':');
+        if (section == "metrics") {
+          expect('{');
+          while (peek() != '}') {
+            const auto name = read_string();
+            expect(':');
+            result[name] = read_metric();
+            if (peek() == ',') ++position_;
+          }
+          expect('}');
+        } else {
+          skip_value();
+        }
+        if (peek() == ',') ++position_;
+      }
+      return result;
+    }
+
+  private:
+    metric read_metric() {
+      metric result;
+      expect('{');
+      while (peek() != '}') {
+        const auto field = read_string();
+        expect(':');
+        const auto value = read_number();
+        if (field == "value") result.value = value;
+        if (field == "tolerance") result.tolerance = value;
+        if (peek() == ',') ++position_;
+      }
+      expect('}');
+      return result;
+    }
+
+    char peek() {
+      while (position_ < text_.size()
+             && std::isspace(static_cast<unsigned char>(text_[position_])) != 0) {
+        ++position_;
+      }
+      if (position_ == text_.size()) throw std::runtime_error("unexpected end of baseline");
+      return text_[position_];
+    }
+
+    void expect(char expected) {
+      if (peek() != expected) {
+        throw std::runtime_error(std::string("expected '") + expected + "' in baseline");
+      }
+      ++position_;
+    }
+
+    std::string read_string() {
+      expect('"');
+      const auto end = text_.find('"', position_);
+      if (end == std::string::npos) throw std::runtime_error("unterminated string in baseline");
+      auto result = text_.substr(position_, end - position_);
+      position_ = end + 1;
+      return result;
+    }
+
+    double read_number() {
+      peek();
+      std::size_t used = 0;
+      const auto value = std::stod(text_.substr(position_), &used);
+      position_ += used;
+      return value;
+    }
+
+    void skip_value() {
+      if (peek() == '"') {
+        read_string();
+        return;
+      }
+      if (peek() != '{') {
+        read_number();
+        return;
+      }
+      expect('{');
+      while (peek() != '}') {
+        read_string();
+        expect(':');
+        skip_value();
+        if (peek() == ',') ++position_;
+      }
+      expect('}');
+    }
+
+    std::string text_;
+    std::size_t position_{0};
+  };
+
+  void write_json(std::ostream &out, const metrics &values) {
+    out << "{\n  \"metrics\": {\n";
+    for (auto it = values.begin(); it != values.end(); ++it) {
+      out << "    \"" << it->first << "\": {\"value\": " << it->second.value
+          << ", \"tolerance\": " << it->second.tolerance << '}'
+          << (std::next(it) == values.end() ? "\n" : ",\n");
+    }
+    out << "  }\n}\n";
+  }
+
+  int compare(const metrics &baseline, const metrics &measured) {
+    auto failures = 0;
+    for (const auto &[name, expected] : baseline) {
+      const auto found = measured.find(name);
+      if (found == measured.end()) {
+        std::cout << "MISSING  " << name << '\n';
+        ++failures;
+        continue;
+      }
+      const auto limit = expected.value * (1.0 + expected.tolerance);
+      const auto regressed = found->second.value > limit;
+      std::cout << (regressed ? "REGRESSED " : "ok        ") << name << ": "
+                << found->second.value << " (baseline " << expected.value << ", limit " << limit
+                << ")\n";
+      if (regressed) ++failures;
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::string baseline_path;
+  std::string output_path;
+  double tolerance = -1.0;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string option = argv[i];
+    if (option == "--baseline") {
+      baseline_path = argv[i + 1];
+    } else if (option == "--write-baseline") {
+      output_path = argv[i + 1];
+    } else if (option == "--tolerance") {
+      tolerance = std::stod(argv[i + 1]);
+    } else {
+      std::cerr << "unknown option " << option << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+
+  auto measured = measure();
+
+  if (!output_path.empty()) {
+    if (tolerance >= 0.0) {
+      for (auto &entry : measured) entry.second.tolerance = tolerance;
+    }
+    std::ofstream out(output_path);
+    write_json(out, measured);
+    std::cout << "wrote " << output_path << '\n';
+    return out ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  if (baseline_path.empty()) {
+    write_json(std::cout, measured);
+    return EXIT_SUCCESS;
+  }
+
+  std::ifstream in(baseline_path);
+  if (!in) {
+    std::cerr << "cannot read baseline " << baseline_path << '\n';
+    return EXIT_FAILURE;
+  }
+  std::stringstream text;
+  text << in.rdbuf();
+  try {
+    return compare(baseline_reader(text.str()).read(), measured);
+  } catch (const std::exception &error) {
+    std::cerr << "invalid baseline " << baseline_path << ": " << error.what() << '\n';
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,646 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#if defined(__linux__)
+#  include <poll.h>
+#  include <pthread.h>
+#  include <signal.h>
+#  include <sys/eventfd.h>
+#  include <sys/timerfd.h>
+#  include <time.h>
+#  include <unistd.h>
+
+#  include <cerrno>
+#  include <cstdint>
+#  include <system_error>
+#  include <thread>
+#endif
+
+namespace dp {
+  /**
+   * @brief Mechanisms that can be used to sleep until a deadline.
+   */
+  enum class wait_backend { condition_variable, clock_nanosleep, timerfd, spin, hybrid, simulated };
+
+  [[nodiscard]] constexpr const char *to_string(wait_backend backend) noexcept {
+    switch (backend) {
+      case wait_backend::condition_variable:
+        return "condition_variable";
+      case wait_backend::clock_nanosleep:
+        return "clock_nanosleep";
+      case wait_backend::timerfd:
+        return "timerfd";
+      case wait_backend::spin:
+        return "spin";
+      case wait_backend::hybrid:
+        return "hybrid";
+      case wait_backend::simulated:
+        return "simulated";
+    }
+    return "unknown";
+  }
+
+  /**
+   * @brief Why a backend's wait() returned.
+   */
+  enum class wait_status { expired, woken };
+
+  /**
+   * @brief Wait backends used by timer threads to sleep until their next deadline.
+   * @details Every backend provides:
+   * - <tt>time_point now() const</tt>: the current time as seen by the backend.
+   * - <tt>void arm(time_point deadline)</tt>: set the absolute deadline of the next wait().
+   * - <tt>void cancel()</tt>: clear the deadline; wait() then only returns when woken.
+   * - <tt>wait_status wait()</tt>: block until the deadline has passed (expired) or wake() was
+   *   called (woken). A deadline in the past expires immediately. If both happened, woken is
+   *   reported and the next wait() expires right away.
+   * - <tt>void wake()</tt>: make the current or next wait() return woken. Wakeups are latched,
+   *   so a wake() that happens before wait() is not lost. Several wakes may coalesce into one.
+   *
+   * arm(), cancel() and wait() are called by the thread that owns the backend (handing it over
+   * to a new thread is fine); wake() may be called from any thread. Backends are default
+   * constructible and neither copied nor moved. tests/src/backend_tests.cpp holds the
+   * conformance tests every backend has to pass.
+   */
+  namespace backends {
+    using clock_type = std::chrono::steady_clock;
+    using time_point = clock_type::time_point;
+
+    /**
+     * @brief Portable backend built on std::condition_variable (default).
+     */
+    class condition_variable_backend {
+    public:
+      static constexpr wait_backend kind = wait_backend::condition_variable;
+
+      condition_variable_backend() = default;
+      condition_variable_backend(const condition_variable_backend &) = delete;
+      condition_variable_backend &operator=(const condition_variable_backend &) = delete;
+      ~condition_variable_backend() = default;
+
+      [[nodiscard]] time_point now() const { return clock_type::now(); }
+      void arm(const time_point &deadline) noexcept {
+        deadline_ = deadline;
+        armed_ = deadline != time_point::max();
+      }
+      void cancel() noexcept { armed_ = false; }
+
+      wait_status wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (armed_) {
+          condition_.wait_until(lock, deadline_, [this]() { return woken_; });
+        } else {
+          condition_.wait(lock, [this]() { return woken_; });
+        }
+        if (!woken_) return wait_status::expired;
+        woken_ = false;
+        return wait_status::woken;
+      }
+
+      void wake() {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          woken_ = true;
+        }
+        condition_.notify_one();
+      }
+
+    private:
+      std::mutex mutex_{};
+      std::condition_variable condition_{};
+      time_point deadline_{};
+      bool armed_{false};
+      bool woken_{false};
+    };
+
+    /**
+     * @brief Busy waits on the clock. Lowest wakeup latency, but occupies a core while waiting.
+     */
+    class spin_backend {
+    public:
+      static constexpr wait_backend kind = wait_backend::spin;
+
+      spin_backend() = default;
+      spin_backend(const spin_backend &) = delete;
+      spin_backend &operator=(const spin_backend &) = delete;
+      ~spin_backend() = default;
+
+      [[nodiscard]] time_point now() const { return clock_type::now(); }
+      void arm(const time_point &deadline) noexcept {
+        deadline_ = deadline;
+        armed_ = deadline != time_point::max();
+      }
+      void cancel() noexcept { armed_ = false; }
+
+      wait_status wait() noexcept {
+        while (true) {
+          if (woken_.exchange(false, std::memory_order_acquire)) return wait_status::woken;
+          if (armed_ && clock_type::now() >= deadline_) return wait_status::expired;
+        }
+      }
+
+      void wake() noexcept { woken_.store(true, std::memory_order_release); }
+
+    private:
+      time_point deadline_{};
+      bool armed_{false};
+      std::atomic_bool woken_{false};
+    };
+
+    /**
+     * @brief Sleeps on @p SleepBackend until spin_threshold() before the deadline, then spins for
+     * the rest.
+     * @details Spinning absorbs the sleeping backend's wakeup lateness at the cost of the CPU
+     * time spent spinning. The threshold is shared by every hybrid_backend<SleepBackend> and is
+     * read by arm(); a good value is the p99 lateness calibrate() measured for the sleeping
+     * backend, see calibration_result::spin_threshold(). With the default threshold of zero the
+     * backend sleeps like @p SleepBackend.
+     */
+    template <typename SleepBackend = condition_variable_backend> class hybrid_backend {
+    public:
+      using sleep_backend = SleepBackend;
+      static constexpr wait_backend kind = wait_backend::hybrid;
+
+      hybrid_backend() = default;
+      hybrid_backend(const hybrid_backend &) = delete;
+      hybrid_backend &operator=(const hybrid_backend &) = delete;
+      ~hybrid_backend() = default;
+
+      /// @brief Set how long before each deadline to stop sleeping and start spinning.
+      static void set_spin_threshold(const std::chrono::nanoseconds &threshold) noexcept {
+        threshold_storage().store(std::max(threshold, std::chrono::nanoseconds{0}).count(),
+                                  std::memory_order_relaxed);
+      }
+      [[nodiscard]] static std::chrono::nanoseconds spin_threshold() noexcept {
+        return std::chrono::nanoseconds{threshold_storage().load(std::memory_order_relaxed)};
+      }
+
+      [[nodiscard]] time_point now() const { return sleeper_.now(); }
+      void arm(const time_point &deadline) {
+        deadline_ = deadline;
+        armed_ = deadline != time_point::max();
+        sleep_until_ = armed_ ? deadline - spin_threshold() : deadline;
+        sleeper_.arm(sleep_until_);
+      }
+      void cancel() {
+        armed_ = false;
+        sleeper_.cancel();
+      }
+
+      wait_status wait() {
+        while (true) {
+          if (woken_.exchange(false, std::memory_order_acquire)) return wait_status::woken;
+          const auto current = sleeper_.now();
+          if (armed_ && current >= deadline_) return wait_status::expired;
+          if (armed_ && current >= sleep_until_) continue;
+          // woken_ is the source of truth, the sleeper is only woken to end the sleep, so a
+          // wake it latched after the previous sleep ended just costs another round
+          sleeping_.store(true);
+          if (!woken_.load()) sleeper_.wait();
+          sleeping_.store(false, std::memory_order_relaxed);
+        }
+      }
+
+      void wake() {
+        woken_.store(true);
+        if (sleeping_.load()) sleeper_.wake();
+      }
+
+    private:
+      static std::atomic<std::chrono::nanoseconds::rep> &threshold_storage() noexcept {
+        static std::atomic<std::chrono::nanoseconds::rep> threshold{0};
+        return threshold;
+      }
+
+      SleepBackend sleeper_{};
+      time_point deadline_{};
+      time_point sleep_until_{};
+      bool armed_{false};
+      std::atomic_bool woken_{false};
+      std::atomic_bool sleeping_{false};
+    };
+
+#if defined(__linux__)
+    namespace details {
+      inline timespec to_timespec(const time_point &deadline) {
+        using seconds_type = std::chrono::duration<decltype(timespec::tv_sec)>;
+        using nanoseconds_type = std::chrono::duration<decltype(timespec::tv_nsec), std::nano>;
+        const auto since_epoch = deadline.time_since_epoch();
+        const auto seconds = std::chrono::duration_cast<seconds_type>(since_epoch);
+        timespec spec{};
+        spec.tv_sec = seconds.count();
+        spec.tv_nsec = std::chrono::duration_cast<nanoseconds_type>(since_epoch - seconds).count();
+        return spec;
+      }
+    }  // namespace details
+
+    /**
+     * @brief Sleeps with clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME) in a single call up to
+     * the deadline, so an idle or long interval timer does not wake up in between.
+     * @details wake() interrupts the sleep by queueing the real-time signal wake_signal() to the
+     * sleeping thread, which makes clock_nanosleep return EINTR. The signal's handler also moves
+     * the pending sleep's deadline into the past, so a signal that arrives just before the
+     * thread enters clock_nanosleep is not lost. Signals are only sent while a thread sleeps in
+     * wait(), and wait() does not return before its signals were handled.
+     *
+     * The handler is installed on the first construction. wait() unblocks the signal on the
+     * calling thread, e.g. a timer thread spawned by an application that blocks real-time
+     * signals. If a signal is nevertheless not handled, wait() gives up on it after
+     * max_signal_latency; should it arrive later, it ends a later sleep early. That only happens
+     * if the signal is blocked again on a thread that has waited on the backend before.
+     * @throws std::system_error on construction if another handler owns wake_signal().
+     * @note steady_clock is backed by CLOCK_MONOTONIC on Linux.
+     */
+    class clock_nanosleep_backend {
+    public:
+      static constexpr wait_backend kind = wait_backend::clock_nanosleep;
+
+      clock_nanosleep_backend() { install_handler(); }
+      clock_nanosleep_backend(const clock_nanosleep_backend &) = delete;
+      clock_nanosleep_backend &operator=(const clock_nanosleep_backend &) = delete;
+      ~clock_nanosleep_backend() = default;
+
+      /// @brief Signal used to interrupt a sleeping thread.
+      [[nodiscard]] static int wake_signal() noexcept { return SIGRTMIN; }
+
+      /// @brief How long wait() waits at most for a signal sent to it to be handled.
+      static constexpr std::chrono::milliseconds max_signal_latency{100};
+
+      [[nodiscard]] time_point now() const { return clock_type::now(); }
+      void arm(const time_point &deadline) noexcept {
+        deadline_ = deadline;
+        armed_ = deadline != time_point::max();
+      }
+      void cancel() noexcept { armed_ = false; }
+
+      wait_status wait() {
+        unblock_wake_signal();
+        while (true) {
+          if (woken_.exchange(false, std::memory_order_acquire)) return wait_status::woken;
+          if (armed_ && clock_type::now() >= deadline_) return wait_status::expired;
+          // returns early when interrupted by any signal: loop and check again
+          sleep(armed_ ? deadline_ : time_point::max());
+        }
+      }
+
+      void wake() noexcept {
+        woken_.store(true, std::memory_order_seq_cst);
+        auto expected = sleep_state::sleeping;
+        if (!state_.compare_exchange_strong(expected, sleep_state::signaling,
+                                            std::memory_order_seq_cst)) {
+          // not sleeping: wait() checks woken_ before it sleeps. Otherwise another wake() is
+          // interrupting this sleep already
+          return;
+        }
+        sigval value{};
+        value.sival_ptr = this;
+        in_flight_.fetch_add(1, std::memory_order_relaxed);
+        if (::pthread_sigqueue(sleeper_, wake_signal(), value) == 0) {
+          // one signal per sleep is enough
+          state_.store(sleep_state::signaled, std::memory_order_release);
+        } else {
+          in_flight_.fetch_sub(1, std::memory_order_relaxed);
+          state_.store(sleep_state::sleeping, std::memory_order_release);
+        }
+      }
+
+    private:
+      enum class sleep_state : std::uint8_t { awake, sleeping, signaling, signaled };
+
+      static void install_handler() {
+        static const bool installed = []() {
+          struct sigaction action {};
+          action.sa_sigaction = &on_wake_signal;
+          // restart other interrupted system calls; clock_nanosleep is never restarted
+          action.sa_flags = SA_SIGINFO | SA_RESTART;
+          sigemptyset(&action.sa_mask);
+          struct sigaction previous {};
+          if (::sigaction(wake_signal(), nullptr, &previous) != 0) return false;
+          if ((previous.sa_flags & SA_SIGINFO) == 0 && previous.sa_handler != SIG_DFL) {
+            return false;
+          }
+          if ((previous.sa_flags & SA_SIGINFO) != 0 && previous.sa_sigaction != &on_wake_signal) {
+            return false;
+          }
+          return ::sigaction(wake_signal(), &action, nullptr) == 0;
+        }();
+        if (!installed) {
+          throw std::system_error(EBUSY, std::generic_category(),
+                                  "clock_nanosleep_backend: wake signal is in use");
+        }
+      }
+
+      /// @brief Once per thread, so that a mask inherited from the spawning thread does not
+      /// keep wake() from interrupting the sleep.
+      static void unblock_wake_signal() noexcept {
+        thread_local const bool unblocked = []() {
+          sigset_t signals{};
+          sigemptyset(&signals);
+          sigaddset(&signals, wake_signal());
+          return ::pthread_sigmask(SIG_UNBLOCK, &signals, nullptr) == 0;
+        }();
+        static_cast<void>(unblocked);
+      }
+
+      static void on_wake_signal(int, siginfo_t *info, void *) noexcept {
+        if (info == nullptr || info->si_code != SI_QUEUE || info->si_pid != ::getpid()) return;
+        auto *self = static_cast<clock_nanosleep_backend *>(info->si_value.sival_ptr);
+        // a sleep that has not started yet expires right away
+        self->target_ = timespec{};
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        self->in_flight_.fetch_sub(1, std::memory_order_release);
+      }
+
+      void sleep(const time_point &deadline) noexcept {
+        target_ = details::to_timespec(deadline);
+        sleeper_ = ::pthread_self();
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        state_.store(sleep_state::sleeping, std::memory_order_seq_cst);
+        // a wake() that stored woken_ before the state change did not signal
+        if (!woken_.load(std::memory_order_seq_cst)) {
+          ::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target_, nullptr);
+        }
+        // let a wake() that is signalling this thread finish, then let its signal arrive so
+        // that it is not handled after wait() returned
+        auto current = state_.load(std::memory_order_acquire);
+        do {
+          while (current == sleep_state::signaling) {
+            std::this_thread::yield();
+            current = state_.load(std::memory_order_acquire);
+          }
+        } while (!state_.compare_exchange_weak(current, sleep_state::awake,
+                                               std::memory_order_acq_rel));
+        const auto give_up = clock_type::now() + max_signal_latency;
+        auto in_flight = in_flight_.load(std::memory_order_acquire);
+        while (in_flight > 0) {
+          if (clock_type::now() >= give_up) {
+            // write the signal off, so that later sleeps do not wait for it as well. If it
+            // arrives after all, it ends the next sleep early, which wait() tolerates
+            in_flight_.fetch_sub(in_flight, std::memory_order_relaxed);
+            break;
+          }
+          std::this_thread::yield();
+          in_flight = in_flight_.load(std::memory_order_acquire);
+        }
+      }
+
+      time_point deadline_{};
+      bool armed_{false};
+      std::atomic_bool woken_{false};
+      std::atomic<sleep_state> state_{sleep_state::awake};
+      ::pthread_t sleeper_{};
+      timespec target_{};
+      /// @brief Signals sent by wake() that the handler has not run for yet.
+      std::atomic<std::int32_t> in_flight_{0};
+    };
+
+    /**
+     * @brief Waits on a timerfd armed at an absolute deadline, woken through an eventfd.
+     */
+    class timerfd_backend {
+    public:
+      static constexpr wait_backend kind = wait_backend::timerfd;
+
+      timerfd_backend()
+          : timer_fd_(::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK)),
+            wake_fd_(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+        if (timer_fd_ < 0 || wake_fd_ < 0) {
+          const auto error = errno;
+          close();
+          throw std::system_error(error, std::generic_category(), "timerfd_backend");
+        }
+      }
+      timerfd_backend(const timerfd_backend &) = delete;
+      timerfd_backend &operator=(const timerfd_backend &) = delete;
+      ~timerfd_backend() { close(); }
+
+      [[nodiscard]] time_point now() const { return clock_type::now(); }
+
+      void arm(const time_point &deadline) noexcept {
+        if (deadline == time_point::max()) {
+          cancel();
+          return;
+        }
+        itimerspec spec{};
+        spec.it_value = details::to_timespec(deadline);
+        // a zero it_value would disarm the timer instead of expiring right away
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) spec.it_value.tv_nsec = 1;
+        ::timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+      }
+
+      void cancel() noexcept {
+        const itimerspec spec{};
+        ::timerfd_settime(timer_fd_, 0, &spec, nullptr);
+      }
+
+      /// @throws std::system_error if poll() fails for another reason than a signal, or reports
+      /// an invalid descriptor.
+      wait_status wait() {
+        std::array<pollfd, 2> fds{{{wake_fd_, POLLIN, 0}, {timer_fd_, POLLIN, 0}}};
+        while (true) {
+          if (::poll(fds.data(), fds.size(), -1) < 0) {
+            // interrupted by a signal: poll again
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "timerfd_backend: poll");
+          }
+          // a closed or broken descriptor would be reported as ready on every call
+          if (((fds[0].revents | fds[1].revents) & (POLLERR | POLLNVAL)) != 0) {
+            throw std::system_error(EBADF, std::generic_category(), "timerfd_backend: poll");
+          }
+          std::uint64_t count{};
+          if ((fds[0].revents & POLLIN) != 0 && ::read(wake_fd_, &count, sizeof(count)) > 0) {
+            return wait_status::woken;
+          }
+          if ((fds[1].revents & POLLIN) != 0 && ::read(timer_fd_, &count, sizeof(count)) > 0) {
+            return wait_status::expired;
+          }
+        }
+      }
+
+      void wake() noexcept {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const auto bytes = ::write(wake_fd_, &one, sizeof(one));
+      }
+
+    private:
+      void close() noexcept {
+        if (timer_fd_ >= 0) ::close(timer_fd_);
+        if (wake_fd_ >= 0) ::close(wake_fd_);
+        timer_fd_ = wake_fd_ = -1;
+      }
+
+      int timer_fd_;
+      int wake_fd_;
+    };
+#endif
+
+    class simulated_backend;
+  }  // namespace backends
+
+  /**
+   * @brief Process wide simulated time for backends::simulated_backend.
+   * @details Time only moves when advance() or advance_to() is called. Advancing steps through
+   * the deadlines of waiting simulated backends one at a time, and after each step waits until
+   * every backend that expired (or was woken) is waiting again. A timer thread therefore runs
+   * each tick, including its callback, before time moves on, which makes tick counts and
+   * timestamps exact. A backend counts as busy from arm() or a returning wait() until its next
+   * wait() or cancel().
+   */
+  class simulated_clock {
+  public:
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::steady_clock::time_point;
+    static constexpr bool is_steady = true;
+
+    [[nodiscard]] static time_point now() noexcept {
+      return time_point{duration{shared().now.load(std::memory_order_acquire)}};
+    }
+
+    static void advance(const duration &amount) { advance_to(now() + amount); }
+
+    static void advance_to(const time_point &target);
+
+    /**
+     * @brief Set the simulated time, e.g. between tests. Does not expire any deadline.
+     */
+    static void reset(const time_point &time = time_point{}) noexcept {
+      std::lock_guard<std::mutex> lock(shared().mutex);
+      shared().now.store(time.time_since_epoch().count(), std::memory_order_release);
+    }
+
+  private:
+    friend class backends::simulated_backend;
+
+    struct state {
+      std::mutex mutex{};
+      std::condition_variable changed{};
+      std::condition_variable settled{};
+      std::atomic<rep> now{0};
+      std::vector<backends::simulated_backend *> backends{};
+    };
+
+    static state &shared() {
+      static state instance{};
+      return instance;
+    }
+  };
+
+  namespace backends {
+    /**
+     * @brief Waits on simulated_clock instead of real time, for deterministic tests.
+     */
+    class simulated_backend {
+    public:
+      static constexpr wait_backend kind = wait_backend::simulated;
+
+      simulated_backend() {
+        std::lock_guard<std::mutex> lock(simulated_clock::shared().mutex);
+        simulated_clock::shared().backends.push_back(this);
+      }
+      simulated_backend(const simulated_backend &) = delete;
+      simulated_backend &operator=(const simulated_backend &) = delete;
+      ~simulated_backend() {
+        auto &clock = simulated_clock::shared();
+        {
+          std::lock_guard<std::mutex> lock(clock.mutex);
+          clock.backends.erase(std::find(clock.backends.begin(), clock.backends.end(), this));
+        }
+        clock.settled.notify_all();
+      }
+
+      [[nodiscard]] time_point now() const noexcept { return simulated_clock::now(); }
+
+      void arm(const time_point &deadline) {
+        std::lock_guard<std::mutex> lock(simulated_clock::shared().mutex);
+        deadline_ = deadline;
+        armed_ = deadline != time_point::max();
+        busy_ = true;
+      }
+
+      void cancel() {
+        auto &clock = simulated_clock::shared();
+        {
+          std::lock_guard<std::mutex> lock(clock.mutex);
+          armed_ = false;
+          busy_ = false;
+        }
+        clock.settled.notify_all();
+      }
+
+      wait_status wait() {
+        auto &clock = simulated_clock::shared();
+        std::unique_lock<std::mutex> lock(clock.mutex);
+        busy_ = false;
+        waiting_ = true;
+        clock.settled.notify_all();
+        clock.changed.wait(lock, [this]() { return woken_ || expired(); });
+        waiting_ = false;
+        busy_ = true;
+        if (!woken_) return wait_status::expired;
+        woken_ = false;
+        return wait_status::woken;
+      }
+
+      void wake() {
+        auto &clock = simulated_clock::shared();
+        {
+          std::lock_guard<std::mutex> lock(clock.mutex);
+          woken_ = true;
+          // time must not move on before the woken thread has reacted
+          if (waiting_) busy_ = true;
+        }
+        clock.changed.notify_all();
+      }
+
+    private:
+      friend class dp::simulated_clock;
+
+      [[nodiscard]] bool expired() const noexcept {
+        return armed_ && simulated_clock::now() >= deadline_;
+      }
+
+      // guarded by the simulated clock's mutex
+      time_point deadline_{};
+      bool armed_{false};
+      bool waiting_{false};
+      bool busy_{false};
+      bool woken_{false};
+    };
+  }  // namespace backends
+
+  inline void simulated_clock::advance_to(const time_point &target) {
+    auto &clock = shared();
+    std::unique_lock<std::mutex> lock(clock.mutex);
+    while (true) {
+      clock.settled.wait(lock, [&clock]() {
+        return std::none_of(clock.backends.begin(), clock.backends.end(),
+                            [](const auto *backend) { return backend->busy_; });
+      });
+      // step to the earliest deadline up to the target
+      auto next = target;
+      auto due = false;
+      for (const auto *backend : clock.backends) {
+        if (backend->waiting_ && backend->armed_ && backend->deadline_ <= next) {
+          next = backend->deadline_;
+          due = true;
+        }
+      }
+      if (next > now()) clock.now.store(next.time_since_epoch().count(), std::memory_order_release);
+      if (!due) break;
+      for (auto *backend : clock.backends) {
+        if (backend->waiting_ && backend->expired()) backend->busy_ = true;
+      }
+      clock.changed.notify_all();
+    }
+  }
+}  // namespace dp
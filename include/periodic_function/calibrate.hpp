@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <periodic_function/backends.hpp>
+#include <system_error>
+#include <vector>
+
+namespace dp {
+  /**
+   * @brief Wakeup lateness (actual wakeup time - requested deadline) measured for one backend.
+   */
+  struct backend_calibration {
+    wait_backend backend{};
+    bool available{false};
+    std::size_t samples{0};
+    std::chrono::nanoseconds min{};
+    std::chrono::nanoseconds p50{};
+    std::chrono::nanoseconds p90{};
+    std::chrono::nanoseconds p99{};
+    std::chrono::nanoseconds max{};
+  };
+
+  struct calibration_options {
+    /// @brief Number of sleeps measured per backend.
+    std::size_t samples{200};
+    /// @brief Requested sleep duration for each sample.
+    std::chrono::nanoseconds interval{std::chrono::milliseconds{1}};
+  };
+
+  struct calibration_result {
+    std::vector<backend_calibration> backends{};
+    /// @brief Sleeping backend with the lowest p99 lateness on this host.
+    wait_backend recommended_backend{wait_backend::condition_variable};
+    /**
+     * @brief Recommended spin threshold for the recommended backend.
+     * @details Sleeping until <tt>deadline - threshold</tt> and spinning for the rest removes the
+     * p99 wakeup lateness at the cost of the CPU time spent spinning. Pass it to
+     * backends::hybrid_backend<B>::set_spin_threshold() where B is the recommended backend.
+     */
+    std::chrono::nanoseconds recommended_spin_threshold{};
+
+    [[nodiscard]] const backend_calibration *find(wait_backend backend) const noexcept {
+      const auto it = std::find_if(backends.begin(), backends.end(), [backend](const auto &entry) {
+        return entry.backend == backend;
+      });
+      return it == backends.end() ? nullptr : &*it;
+    }
+
+    /**
+     * @brief Spin threshold for a backends::hybrid_backend sleeping on @p backend: its p99
+     * lateness, or zero if the backend was not measured.
+     */
+    [[nodiscard]] std::chrono::nanoseconds spin_threshold(wait_backend backend) const noexcept {
+      const auto *entry = find(backend);
+      if (entry == nullptr || !entry->available) return std::chrono::nanoseconds{0};
+      return std::max(entry->p99, std::chrono::nanoseconds{0});
+    }
+  };
+
+  namespace details {
+    inline backend_calibration unavailable_backend(wait_backend backend) {
+      backend_calibration result{};
+      result.backend = backend;
+      return result;
+    }
+
+    template <typename Backend>
+    backend_calibration measure_backend(const calibration_options &options) {
+      Backend backend{};
+      std::vector<std::chrono::nanoseconds> lateness;
+      lateness.reserve(options.samples);
+      for (std::size_t i = 0; i < options.samples; ++i) {
+        const auto deadline = backend.now() + options.interval;
+        backend.arm(deadline);
+        while (backend.wait() != wait_status::expired) {
+        }
+        lateness.push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(backend.now() - deadline));
+      }
+
+      backend_calibration result{};
+      result.backend = Backend::kind;
+      result.available = true;
+      result.samples = lateness.size();
+      if (lateness.empty()) return result;
+
+      std::sort(lateness.begin(), lateness.end());
+      const auto percentile = [&lateness](std::size_t pct) {
+        return lateness[(lateness.size() - 1) * pct / 100];
+      };
+      result.min = lateness.front();
+      result.p50 = percentile(50);
+      result.p90 = percentile(90);
+      result.p99 = percentile(99);
+      result.max = lateness.back();
+      return result;
+    }
+  }  // namespace details
+
+  /**
+   * @brief Measure the wakeup lateness of every wait backend available on this host.
+   * @details Each backend sleeps @c options.samples times for @c options.interval and records
+   * how late it woke up. The sleeping backend with the lowest p99 lateness is recommended, along
+   * with a spin threshold for backends::hybrid_backend equal to its p99 lateness. Spinning is
+   * measured as a reference but is never recommended on its own since it occupies a core. This
+   * blocks the calling thread for roughly <tt>backends * samples * interval</tt>.
+   */
+  inline calibration_result calibrate(const calibration_options &options = {}) {
+    calibration_result result{};
+
+    result.backends.push_back(
+        details::measure_backend<backends::condition_variable_backend>(options));
+
+#if defined(__linux__)
+    try {
+      result.backends.push_back(
+          details::measure_backend<backends::clock_nanosleep_backend>(options));
+    } catch (const std::system_error &) {
+      result.backends.push_back(details::unavailable_backend(wait_backend::clock_nanosleep));
+    }
+    try {
+      result.backends.push_back(details::measure_backend<backends::timerfd_backend>(options));
+    } catch (const std::system_error &) {
+      result.backends.push_back(details::unavailable_backend(wait_backend::timerfd));
+    }
+#else
+    result.backends.push_back(details::unavailable_backend(wait_backend::clock_nanosleep));
+    result.backends.push_back(details::unavailable_backend(wait_backend::timerfd));
+#endif
+
+    result.backends.push_back(details::measure_backend<backends::spin_backend>(options));
+
+    const backend_calibration *best = nullptr;
+    for (const auto &entry : result.backends) {
+      if (!entry.available || entry.backend == wait_backend::spin) continue;
+      if (best == nullptr || entry.p99 < best->p99) best = &entry;
+    }
+    if (best != nullptr) {
+      result.recommended_backend = best->backend;
+      result.recommended_spin_threshold = result.spin_threshold(best->backend);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Write a human readable report of a calibration run.
+   */
+  inline std::ostream &operator<<(std::ostream &stream, const calibration_result &result) {
+    const auto micros = [](std::chrono::nanoseconds value) {
+      return static_cast<double>(value.count()) / 1000.0;
+    };
+    stream << "wakeup lateness (us):\n";
+    for (const auto &entry : result.backends) {
+      stream << "  " << to_string(entry.backend) << ": ";
+      if (!entry.available) {
+        stream << "unavailable\n";
+        continue;
+      }
+      stream << "min " << micros(entry.min) << ", p50 " << micros(entry.p50) << ", p90 "
+             << micros(entry.p90) << ", p99 " << micros(entry.p99) << ", max "
+             << micros(entry.max) << " (" << entry.samples << " samples)\n";
+    }
+    stream << "recommended: " << to_string(result.recommended_backend)
+           << " with a spin threshold of " << micros(result.recommended_spin_threshold) << " us\n";
+    return stream;
+  }
+}  // namespace dp
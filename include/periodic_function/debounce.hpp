@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <periodic_function/scheduler.hpp>
+#include <utility>
+
+namespace dp {
+  namespace details {
+    inline scheduler::time_type::rep to_ticks(const scheduler::time_point &time) noexcept {
+      return time.time_since_epoch().count();
+    }
+
+    inline scheduler::time_point from_ticks(scheduler::time_type::rep ticks) noexcept {
+      return scheduler::time_point{scheduler::time_type{ticks}};
+    }
+  }  // namespace details
+
+  /**
+   * @brief Coalesce bursts of events into one call once no event arrived for a quiet period.
+   * @details Runs on a dormant timer of a shared scheduler, so it costs no thread of its own and
+   * no wakeups while there are no events. notify() is lock free: a steady_clock read (no system
+   * call where the clock is read through the vDSO) and a release compare-exchange of one atomic
+   * word that holds the time of the last event and whether the timer is armed. Only the first
+   * event of a burst takes the scheduler's lock, to arm the timer.
+   * benchmark/src/debounce_notify.cpp measures the cost per call.
+   * The callback runs on the scheduler's dispatcher thread. The scheduler must outlive the
+   * debouncer.
+   * @tparam WaitBackend wait backend of the scheduler (see basic_scheduler).
+   */
+  template <typename WaitBackend = backends::condition_variable_backend>
+  class basic_debouncer final {
+  public:
+    using scheduler_type = basic_scheduler<WaitBackend>;
+    using time_type = typename scheduler_type::time_type;
+    using time_point = typename scheduler_type::time_point;
+
+    template <typename Callback>
+    basic_debouncer(scheduler_type &timers, Callback &&callback, const time_type &quiet_period,
+                    const timer_options &options = {})
+        : scheduler_(timers),
+          callback_(std::forward<Callback>(callback)),
+          quiet_period_(quiet_period),
+          id_(timers.add_timer([this]() { on_tick(); }, time_type::zero(), options)) {}
+
+    basic_debouncer(const basic_debouncer &) = delete;
+    basic_debouncer &operator=(const basic_debouncer &) = delete;
+
+    /**
+     * @brief Unregisters the timer, waiting for a running callback to finish.
+     */
+    ~basic_debouncer() { scheduler_.remove_timer(id_); }
+
+    /**
+     * @brief Record an event, (re)starting the quiet period.
+     */
+    void notify() {
+      const auto now = scheduler_.now();
+      // the event time and the armed flag change together, so on_tick() can only disarm the
+      // timer if no event arrived since it last looked. Two notifiers may read the clock in one
+      // order and get here in the other, so keep the later time. Release publishes what
+      // happened before the event to the callback, also when the time does not change
+      auto previous = state_.load(std::memory_order_relaxed);
+      auto desired = previous;
+      do {
+        desired = encode(std::max(last_event(previous), now));
+      } while (!state_.compare_exchange_weak(previous, desired, std::memory_order_release,
+                                             std::memory_order_relaxed));
+      if ((previous & armed) == 0) scheduler_.wake_at(id_, last_event(desired) + quiet_period_);
+    }
+
+  private:
+    static constexpr std::uint64_t armed = 1;
+
+    static std::uint64_t encode(const time_point &last_event) noexcept {
+      return (static_cast<std::uint64_t>(details::to_ticks(last_event)) << 1U) | armed;
+    }
+
+    static time_point last_event(std::uint64_t state) noexcept {
+      return details::from_ticks(static_cast<typename time_type::rep>(state >> 1U));
+    }
+
+    void on_tick() {
+      auto current = state_.load(std::memory_order_acquire);
+      while (true) {
+        const auto due = last_event(current) + quiet_period_;
+        if (scheduler_.now() < due) {
+          // more events arrived, wait for the rest of the quiet period
+          scheduler_.wake_at(id_, due);
+          return;
+        }
+        // fails if an event slipped in, whose quiet period has only just started
+        if (state_.compare_exchange_weak(current, current & ~armed, std::memory_order_acquire)) {
+          break;
+        }
+      }
+      callback_();
+    }
+
+    scheduler_type &scheduler_;
+    std::function<void()> callback_;
+    time_type quiet_period_;
+    /// @brief Time of the last event shifted left by one, or'ed with armed.
+    std::atomic<std::uint64_t> state_{0};
+    timer_id id_;
+  };
+
+  using debouncer = basic_debouncer<>;
+
+  /**
+   * @brief Call at most once per interval while events keep arriving.
+   * @details The first event after a quiet spell is handled right away; events within the
+   * following interval are coalesced into one call at the end of it, and so on while events keep
+   * arriving. Like debouncer, this runs on a dormant timer of a shared scheduler and notify() is
+   * lock free except for the first event after the timer went dormant. While an event is already
+   * pending, notify() is a single atomic exchange and does not read the clock. The callback runs
+   * on the scheduler's dispatcher thread. The scheduler must outlive the throttler.
+   * @tparam WaitBackend wait backend of the scheduler (see basic_scheduler).
+   */
+  template <typename WaitBackend = backends::condition_variable_backend>
+  class basic_throttler final {
+  public:
+    using scheduler_type = basic_scheduler<WaitBackend>;
+    using time_type = typename scheduler_type::time_type;
+    using time_point = typename scheduler_type::time_point;
+
+    template <typename Callback>
+    basic_throttler(scheduler_type &timers, Callback &&callback, const time_type &interval,
+                    const timer_options &options = {})
+        : scheduler_(timers),
+          callback_(std::forward<Callback>(callback)),
+          interval_(interval),
+          id_(timers.add_timer([this]() { on_tick(); }, time_type::zero(), options)) {}
+
+    basic_throttler(const basic_throttler &) = delete;
+    basic_throttler &operator=(const basic_throttler &) = delete;
+
+    /**
+     * @brief Unregisters the timer, waiting for a running callback to finish.
+     */
+    ~basic_throttler() { scheduler_.remove_timer(id_); }
+
+    /**
+     * @brief Record an event, to be handled now or at the end of the current interval.
+     */
+    void notify() {
+      // every event writes the flag, so the tick that consumes it sees what happened before
+      // any of the events it covers. An event that was already pending covers this one: the
+      // notifier that set the flag arms the timer. seq_cst pairs with the disarm in on_tick():
+      // it sees this event or we see it disarmed
+      if (pending_.exchange(true)) return;
+      if (armed_.load()) return;
+      if (!armed_.exchange(true)) arm();
+    }
+
+  private:
+    void arm() {
+      const auto next_allowed = details::from_ticks(next_allowed_.load(std::memory_order_acquire));
+      scheduler_.wake_at(id_, std::max(scheduler_.now(), next_allowed));
+    }
+
+    void on_tick() {
+      if (!pending_.exchange(false)) {
+        // a whole interval without events, go dormant
+        armed_.store(false);
+        if (pending_.load() && !armed_.exchange(true)) arm();
+        return;
+      }
+      const auto start = scheduler_.now();
+      next_allowed_.store(details::to_ticks(start + interval_), std::memory_order_release);
+      // stay armed to collect the events of the next interval
+      scheduler_.wake_at(id_, start + interval_);
+      callback_();
+    }
+
+    scheduler_type &scheduler_;
+    std::function<void()> callback_;
+    time_type interval_;
+    std::atomic_bool pending_{false};
+    std::atomic_bool armed_{false};
+    std::atomic<typename time_type::rep> next_allowed_{0};
+    timer_id id_;
+  };
+
+  using throttler = basic_throttler<>;
+}  // namespace dp
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dp {
+  namespace details {
+    /// @brief Position of the most significant set bit of a non-zero value.
+    constexpr unsigned most_significant_bit(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+      return 63U - static_cast<unsigned>(__builtin_clzll(value));
+#else
+      unsigned position = 0;
+      while (value >>= 1U) ++position;
+      return position;
+#endif
+    }
+
+    /// @brief Narrow a 64 bit value that is known to be in range to an array index.
+    template <typename Index = std::size_t> constexpr Index to_index(std::uint64_t value) noexcept {
+      if constexpr (std::is_same_v<Index, std::uint64_t>) {
+        return value;
+      } else {
+        return static_cast<Index>(value);
+      }
+    }
+
+    inline void write_varint(std::vector<std::byte> &out, std::uint64_t value) {
+      while (value >= 0x80U) {
+        out.push_back(static_cast<std::byte>((value & 0x7FU) | 0x80U));
+        value >>= 7U;
+      }
+      out.push_back(static_cast<std::byte>(value));
+    }
+
+    inline std::uint64_t read_varint(const std::byte *&data, const std::byte *end) {
+      std::uint64_t value = 0;
+      for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (data == end) break;
+        const auto byte = std::to_integer<std::uint64_t>(*data++);
+        value |= (byte & 0x7FU) << shift;
+        if ((byte & 0x80U) == 0) return value;
+      }
+      throw std::invalid_argument("dp::latency_histogram: truncated varint");
+    }
+  }  // namespace details
+
+  /**
+   * @brief Fixed size, log-linear latency histogram in the style of HDR histograms.
+   * @details Values below <tt>2^SubBucketBits</tt> nanoseconds get a bucket each. Above that,
+   * every power of two range is split into <tt>2^SubBucketBits</tt> linear buckets, so the
+   * relative error of a recorded value is below <tt>2^-SubBucketBits</tt> (about 3% by default).
+   * Values of <tt>2^MaxValueBits</tt> nanoseconds or more (about 68s by default) are counted in
+   * the last bucket; negative values count as zero.
+   *
+   * record() is a single relaxed atomic increment, so one histogram can be shared by several
+   * threads and read while it is being written. Histograms with the same layout can be merged,
+   * and serialize() writes a compact binary form that only stores non-empty buckets.
+   */
+  template <unsigned SubBucketBits = 5, unsigned MaxValueBits = 36>
+  class basic_latency_histogram {
+    static_assert(SubBucketBits >= 1 && SubBucketBits < MaxValueBits && MaxValueBits <= 63,
+                  "dp::basic_latency_histogram: requires 1 <= SubBucketBits < MaxValueBits <= 63");
+
+  public:
+    static constexpr std::uint64_t sub_bucket_count = std::uint64_t{1} << SubBucketBits;
+    static constexpr std::size_t bucket_count
+        = std::size_t{MaxValueBits - SubBucketBits + 1} << SubBucketBits;
+    static constexpr std::uint64_t max_trackable_value = (std::uint64_t{1} << MaxValueBits) - 1;
+
+    basic_latency_histogram() = default;
+    basic_latency_histogram(const basic_latency_histogram &other) noexcept { merge(other); }
+    basic_latency_histogram &operator=(const basic_latency_histogram &other) noexcept {
+      if (this != &other) {
+        reset();
+        merge(other);
+      }
+      return *this;
+    }
+    ~basic_latency_histogram() = default;
+
+    void record(std::chrono::nanoseconds value) noexcept {
+      record_value(value.count() < 0 ? 0U : static_cast<std::uint64_t>(value.count()));
+    }
+
+    void record_value(std::uint64_t nanoseconds) noexcept {
+      counts_[bucket_index(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @brief Add the counts of @p other to this histogram.
+    void merge(const basic_latency_histogram &other) noexcept {
+      for (std::size_t i = 0; i < bucket_count; ++i) {
+        const auto count = other.counts_[i].load(std::memory_order_relaxed);
+        if (count != 0) counts_[i].fetch_add(count, std::memory_order_relaxed);
+      }
+    }
+
+    void reset() noexcept {
+      for (auto &count : counts_) count.store(0, std::memory_order_relaxed);
+    }
+
+    /// @brief Total number of recorded values.
+    [[nodiscard]] std::uint64_t count() const noexcept {
+      std::uint64_t total = 0;
+      for (const auto &count : counts_) total += count.load(std::memory_order_relaxed);
+      return total;
+    }
+
+    [[nodiscard]] std::uint64_t bucket(std::size_t index) const noexcept {
+      return counts_[index].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Value at the given percentile (0-100), reported as the highest value of its bucket.
+     * @return zero if nothing was recorded.
+     */
+    [[nodiscard]] std::chrono::nanoseconds percentile(double percent) const noexcept {
+      const auto total = count();
+      if (total == 0) return std::chrono::nanoseconds{0};
+      const auto clamped = std::clamp(percent, 0.0, 100.0);
+      auto rank = static_cast<std::uint64_t>(clamped / 100.0 * static_cast<double>(total) + 0.5);
+      rank = std::clamp<std::uint64_t>(rank, 1, total);
+      std::uint64_t seen = 0;
+      for (std::size_t i = 0; i < bucket_count; ++i) {
+        seen += counts_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) return to_duration(highest_equivalent_value(i));
+      }
+      return to_duration(max_trackable_value);
+    }
+
+    /// @brief Lowest recorded value, rounded down to its bucket.
+    [[nodiscard]] std::chrono::nanoseconds min() const noexcept {
+      for (std::size_t i = 0; i < bucket_count; ++i) {
+        if (bucket(i) != 0) return to_duration(lowest_equivalent_value(i));
+      }
+      return std::chrono::nanoseconds{0};
+    }
+
+    /// @brief Highest recorded value, rounded up to its bucket.
+    [[nodiscard]] std::chrono::nanoseconds max() const noexcept {
+      for (auto i = bucket_count; i > 0; --i) {
+        if (bucket(i - 1) != 0) return to_duration(highest_equivalent_value(i - 1));
+      }
+      return std::chrono::nanoseconds{0};
+    }
+
+    [[nodiscard]] static constexpr std::size_t bucket_index(std::uint64_t value) noexcept {
+      if (value < sub_bucket_count) return details::to_index(value);
+      if (value > max_trackable_value) return bucket_count - 1;
+      const auto shift = details::most_significant_bit(value) - SubBucketBits;
+      // the top SubBucketBits + 1 bits select the bucket within the power of two range
+      return details::to_index((std::uint64_t{shift} << SubBucketBits) + (value >> shift));
+    }
+
+    [[nodiscard]] static constexpr std::uint64_t lowest_equivalent_value(
+        std::size_t index) noexcept {
+      if (index < sub_bucket_count) return index;
+      const auto shift = static_cast<unsigned>(index >> SubBucketBits) - 1U;
+      const auto top = sub_bucket_count + (index & (sub_bucket_count - 1));
+      return top << shift;
+    }
+
+    [[nodiscard]] static constexpr std::uint64_t highest_equivalent_value(
+        std::size_t index) noexcept {
+      if (index < sub_bucket_count) return index;
+      const auto shift = static_cast<unsigned>(index >> SubBucketBits) - 1U;
+      return lowest_equivalent_value(index) + (std::uint64_t{1} << shift) - 1U;
+    }
+
+    /**
+     * @brief Compact binary form: a 4 byte magic, format version and layout, followed by
+     * LEB128 varints for the number of non-empty buckets and each bucket's index delta and
+     * count.
+     */
+    [[nodiscard]] std::vector<std::byte> serialize() const {
+      std::vector<std::byte> out{std::byte{'D'}, std::byte{'P'}, std::byte{'L'}, std::byte{'H'},
+                                 std::byte{format_version}, std::byte{SubBucketBits},
+                                 std::byte{MaxValueBits}};
+      std::vector<std::pair<std::size_t, std::uint64_t>> used;
+      for (std::size_t i = 0; i < bucket_count; ++i) {
+        if (const auto count = bucket(i); count != 0) used.emplace_back(i, count);
+      }
+      details::write_varint(out, used.size());
+      std::size_t previous = 0;
+      for (const auto &[index, count] : used) {
+        details::write_varint(out, index - previous);
+        details::write_varint(out, count);
+        previous = index;
+      }
+      return out;
+    }
+
+    /**
+     * @brief Read a histogram written by serialize().
+     * @throws std::invalid_argument if the data is malformed or has a different layout.
+     */
+    [[nodiscard]] static basic_latency_histogram deserialize(const std::byte *data,
+                                                            std::size_t size) {
+      const auto *end = data + size;
+      const std::byte header[] = {std::byte{'D'}, std::byte{'P'}, std::byte{'L'}, std::byte{'H'},
+                                  std::byte{format_version}, std::byte{SubBucketBits},
+                                  std::byte{MaxValueBits}};
+      if (size < sizeof(header) || !std::equal(header, header + sizeof(header), data)) {
+        throw std::invalid_argument("dp::latency_histogram: unknown format or bucket layout");
+      }
+      data += sizeof(header);
+      basic_latency_histogram result{};
+      const auto used = details::read_varint(data, end);
+      std::uint64_t index = 0;
+      for (std::uint64_t i = 0; i < used; ++i) {
+        index += details::read_varint(data, end);
+        const auto count = details::read_varint(data, end);
+        if (index >= bucket_count) {
+          throw std::invalid_argument("dp::latency_histogram: bucket index out of range");
+        }
+        result.counts_[details::to_index(index)].store(count, std::memory_order_relaxed);
+      }
+      return result;
+    }
+
+    [[nodiscard]] static basic_latency_histogram deserialize(const std::vector<std::byte> &data) {
+      return deserialize(data.data(), data.size());
+    }
+
+  private:
+    static constexpr unsigned char format_version = 1;
+
+    static std::chrono::nanoseconds to_duration(std::uint64_t value) noexcept {
+      return std::chrono::nanoseconds{static_cast<std::chrono::nanoseconds::rep>(value)};
+    }
+
+    std::array<std::atomic<std::uint64_t>, bucket_count> counts_{};
+  };
+
+  using latency_histogram = basic_latency_histogram<>;
+
+  /**
+   * @brief Per-timer latency statistics, recorded by the timer thread once attached with
+   * periodic_function::attach_stats().
+   */
+  struct timer_stats {
+    /// @brief Callback execution time (callback end - callback start).
+    latency_histogram execution{};
+    /// @brief Wakeup lateness of regular ticks (callback start - scheduled time).
+    latency_histogram lateness{};
+  };
+}  // namespace dp
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace dp {
+  namespace details {
+    constexpr std::size_t align_up(std::size_t value, std::size_t alignment) {
+      return (value + alignment - 1) / alignment * alignment;
+    }
+
+    /**
+     * @brief Platform wrapper around a shared, read/write file mapping.
+     */
+    class file_mapping {
+    public:
+      file_mapping() = default;
+      /**
+       * @param resize if false, an existing non-empty file must already be @p size bytes long.
+       * Otherwise it is truncated or extended to @p size bytes.
+       * @throws std::invalid_argument if the file has a different size and @p resize is false.
+       */
+      file_mapping(const std::string &path, std::size_t size, bool resize) {
+        open(path, size, resize);
+      }
+      file_mapping(const file_mapping &) = delete;
+      file_mapping &operator=(const file_mapping &) = delete;
+      ~file_mapping() { close(); }
+
+      [[nodiscard]] void *data() const noexcept { return data_; }
+      [[nodiscard]] std::size_t size() const noexcept { return size_; }
+      /// @brief true if the file was missing or empty before it was mapped.
+      [[nodiscard]] bool created() const noexcept { return created_; }
+
+      void flush() const {
+        if (data_ == nullptr) return;
+#ifdef _WIN32
+        FlushViewOfFile(data_, 0);
+#else
+        ::msync(data_, size_, MS_ASYNC);
+#endif
+      }
+
+    private:
+      [[noreturn]] static void throw_last_error(const char *what) {
+#ifdef _WIN32
+        throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), what);
+#else
+        throw std::system_error(errno, std::generic_category(), what);
+#endif
+      }
+
+      static void check_size(std::uint64_t current_size, std::size_t size, bool resize) {
+        if (!resize && current_size != 0 && current_size != size) {
+          throw std::invalid_argument(
+              "dp::file_mapping: existing file has a different size than requested");
+        }
+      }
+
+      void open(const std::string &path, std::size_t size, bool resize) {
+        size_ = size;
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) throw_last_error("CreateFile");
+        LARGE_INTEGER current_size{};
+        GetFileSizeEx(file_, &current_size);
+        const auto file_size = static_cast<std::uint64_t>(current_size.QuadPart);
+        created_ = file_size == 0;
+        try {
+          check_size(file_size, size, resize);
+        } catch (...) {
+          close();
+          throw;
+        }
+        if (file_size > size) {
+          // the mapping below only grows files
+          LARGE_INTEGER end{};
+          end.QuadPart = static_cast<LONGLONG>(size);
+          if (!SetFilePointerEx(file_, end, nullptr, FILE_BEGIN) || !SetEndOfFile(file_)) {
+            const auto error = GetLastError();
+            close();
+            throw std::system_error(static_cast<int>(error), std::system_category(),
+                                    "SetEndOfFile");
+          }
+        }
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READWRITE,
+                                      static_cast<DWORD>(static_cast<std::uint64_t>(size) >> 32U),
+                                      static_cast<DWORD>(size & 0xFFFFFFFFU), nullptr);
+        if (mapping_ == nullptr) {
+          close();
+          throw_last_error("CreateFileMapping");
+        }
+        data_ = MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (data_ == nullptr) {
+          close();
+          throw_last_error("MapViewOfFile");
+        }
+#else
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0) throw_last_error("open");
+        struct stat file_stat {};
+        if (::fstat(fd_, &file_stat) != 0) {
+          close();
+          throw_last_error("fstat");
+        }
+        const auto file_size = static_cast<std::uint64_t>(file_stat.st_size);
+        created_ = file_size == 0;
+        try {
+          check_size(file_size, size, resize);
+        } catch (...) {
+          close();
+          throw;
+        }
+        if (file_size != size && ::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+          close();
+          throw_last_error("ftruncate");
+        }
+        void *mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapped == MAP_FAILED) {
+          close();
+          throw_last_error("mmap");
+        }
+        data_ = mapped;
+#endif
+      }
+
+      void close() noexcept {
+#ifdef _WIN32
+        if (data_ != nullptr) UnmapViewOfFile(data_);
+        if (mapping_ != nullptr) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_ != nullptr) ::munmap(data_, size_);
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+#endif
+        data_ = nullptr;
+      }
+
+#ifdef _WIN32
+      HANDLE file_ = INVALID_HANDLE_VALUE;
+      HANDLE mapping_ = nullptr;
+#else
+      int fd_ = -1;
+#endif
+      void *data_ = nullptr;
+      std::size_t size_ = 0;
+      bool created_ = false;
+    };
+  }  // namespace details
+
+  /**
+   * @brief What opening a mapped_time_series does with an existing file.
+   */
+  enum class series_open_mode : std::uint8_t {
+    /// @brief Resume a series with the same layout, throw if the file holds anything else.
+    open_or_create,
+    /// @brief Discard the file's contents and start a new, empty series.
+    reinitialize
+  };
+
+  /**
+   * @brief Fixed capacity, columnar time series stored in a memory-mapped file.
+   * @details The file starts with a 64 byte @ref header, followed by a column of @c int64
+   * timestamps (nanoseconds since the epoch of @p Clock) and a column of @p Value records. Both
+   * columns start on a 64 byte boundary. Records are written to slot
+   * <tt>write_cursor % capacity</tt>, so the file always holds the latest @c capacity samples.
+   *
+   * Appending only touches mapped memory; there are no system calls per record. A single writer
+   * is supported. Readers (in process or external tools mapping the same file) load the cursor
+   * with acquire semantics and may read slots <tt>[cursor - capacity, cursor)</tt>. The oldest
+   * slot may be overwritten while it is being read, so readers that need exact data should
+   * re-check the cursor after reading.
+   * @tparam Value trivially copyable sample type.
+   * @tparam Clock clock used to timestamp samples.
+   */
+  template <typename Value, typename Clock = std::chrono::system_clock>
+  class mapped_time_series final {
+    static_assert(std::is_trivially_copyable_v<Value>,
+                  "dp::mapped_time_series: Value must be trivially copyable");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "dp::mapped_time_series: requires lock free 64-bit atomics");
+
+  public:
+    using value_type = Value;
+    using clock_type = Clock;
+    using time_point = typename clock_type::time_point;
+
+    static constexpr std::uint32_t format_version = 1;
+    static constexpr char magic[8] = {'D', 'P', 'T', 'S', 'E', 'R', 'I', 'E'};
+
+    /**
+     * @brief On-disk file header. All offsets are in bytes from the start of the file.
+     */
+    struct alignas(64) header {
+      char magic[8];
+      std::uint32_t version;
+      std::uint32_t value_size;
+      std::uint64_t capacity;
+      std::uint64_t timestamps_offset;
+      std::uint64_t values_offset;
+      /// @brief Total number of records ever appended; the next slot is cursor % capacity.
+      std::atomic<std::uint64_t> write_cursor;
+    };
+    static_assert(sizeof(header) == 64);
+
+    /**
+     * @brief Open or create a time series file.
+     * @details If @p path already holds a series with the same layout, appending resumes at its
+     * stored cursor. A missing or empty file is initialized. Any other file is left untouched
+     * and an exception is thrown, unless @p mode is series_open_mode::reinitialize.
+     * @param path file to map.
+     * @param capacity number of records retained before the write cursor wraps.
+     * @throws std::invalid_argument if @p capacity is zero or the file holds something other
+     * than a series of this layout.
+     */
+    mapped_time_series(const std::string &path, std::size_t capacity,
+                       series_open_mode mode = series_open_mode::open_or_create)
+        : capacity_(checked_capacity(capacity)),
+          timestamps_offset_(details::align_up(sizeof(header), 64)),
+          values_offset_(details::align_up(timestamps_offset_ + capacity * sizeof(std::int64_t),
+                                           64)),
+          mapping_(path, values_offset_ + capacity * sizeof(Value),
+                   mode == series_open_mode::reinitialize) {
+      auto *base = static_cast<std::byte *>(mapping_.data());
+      header_ = reinterpret_cast<header *>(base);
+      timestamps_ = reinterpret_cast<std::int64_t *>(base + timestamps_offset_);
+      values_ = reinterpret_cast<Value *>(base + values_offset_);
+
+      if (!mapping_.created() && mode == series_open_mode::open_or_create) {
+        if (!compatible()) {
+          throw std::invalid_argument("dp::mapped_time_series: " + path
+                                      + " holds a different layout");
+        }
+        return;
+      }
+      // fresh file, or its contents are discarded: write the header from scratch
+      header_ = new (base) header{};
+      std::memcpy(header_->magic, magic, sizeof(magic));
+      header_->version = format_version;
+      header_->value_size = static_cast<std::uint32_t>(sizeof(Value));
+      header_->capacity = capacity_;
+      header_->timestamps_offset = timestamps_offset_;
+      header_->values_offset = values_offset_;
+      header_->write_cursor.store(0, std::memory_order_release);
+    }
+
+    mapped_time_series(const mapped_time_series &) = delete;
+    mapped_time_series &operator=(const mapped_time_series &) = delete;
+
+    /**
+     * @brief Append a sample, overwriting the oldest one once the series is full.
+     */
+    void append(const time_point &timestamp, const Value &value) noexcept {
+      const auto cursor = header_->write_cursor.load(std::memory_order_relaxed);
+      const auto slot = static_cast<std::size_t>(cursor % capacity_);
+      timestamps_[slot] = static_cast<std::int64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch())
+              .count());
+      std::memcpy(&values_[slot], &value, sizeof(Value));
+      // publish the record to readers
+      header_->write_cursor.store(cursor + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Append a sample stamped with the current time.
+     */
+    void append(const Value &value) noexcept { append(clock_type::now(), value); }
+
+    /**
+     * @brief Ask the OS to write dirty pages back to the file asynchronously.
+     */
+    void flush() const { mapping_.flush(); }
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+    /**
+     * @brief Total number of records appended over the lifetime of the file.
+     */
+    [[nodiscard]] std::uint64_t write_cursor() const noexcept {
+      return header_->write_cursor.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Number of records currently retained (at most capacity()).
+     */
+    [[nodiscard]] std::size_t size() const noexcept {
+      const auto cursor = write_cursor();
+      return cursor < capacity_ ? static_cast<std::size_t>(cursor) : capacity_;
+    }
+
+    /**
+     * @brief Timestamp of the i-th retained record, 0 being the oldest.
+     */
+    [[nodiscard]] time_point timestamp(std::size_t index) const noexcept {
+      return time_point{std::chrono::duration_cast<typename clock_type::duration>(
+          std::chrono::nanoseconds{timestamps_[slot_of(index)]})};
+    }
+
+    /**
+     * @brief Value of the i-th retained record, 0 being the oldest.
+     */
+    [[nodiscard]] Value value(std::size_t index) const noexcept {
+      Value result;
+      std::memcpy(&result, &values_[slot_of(index)], sizeof(Value));
+      return result;
+    }
+
+  private:
+    static std::size_t checked_capacity(std::size_t capacity) {
+      // checked before the file is opened, so an invalid call leaves it untouched
+      if (capacity == 0) {
+        throw std::invalid_argument("dp::mapped_time_series: capacity must be non-zero");
+      }
+      return capacity;
+    }
+
+    [[nodiscard]] bool compatible() const noexcept {
+      return std::memcmp(header_->magic, magic, sizeof(magic)) == 0
+             && header_->version == format_version && header_->value_size == sizeof(Value)
+             && header_->capacity == capacity_ && header_->timestamps_offset == timestamps_offset_
+             && header_->values_offset == values_offset_;
+    }
+
+    [[nodiscard]] std::size_t slot_of(std::size_t index) const noexcept {
+      const auto cursor = write_cursor();
+      const auto first = cursor < capacity_ ? 0U : cursor - capacity_;
+      return static_cast<std::size_t>((first + index) % capacity_);
+    }
+
+    std::size_t capacity_;
+    std::size_t timestamps_offset_;
+    std::size_t values_offset_;
+    details::file_mapping mapping_;
+    header *header_ = nullptr;
+    std::int64_t *timestamps_ = nullptr;
+    Value *values_ = nullptr;
+  };
+
+  namespace details {
+    template <typename Series, typename Callback> struct series_recorder {
+      Series *series;
+      Callback callback;
+      void operator()() { series->append(callback()); }
+    };
+  }  // namespace details
+
+  /**
+   * @brief Wrap a callable so that each result is appended to @p series with the current time.
+   * @details The returned callable can be handed directly to a periodic_function.
+   */
+  template <typename Value, typename Clock, typename Callback>
+  auto record_to(mapped_time_series<Value, Clock> &series, Callback &&callback) {
+    return details::series_recorder<mapped_time_series<Value, Clock>, std::decay_t<Callback>>{
+        &series, std::forward<Callback>(callback)};
+  }
+}  // namespace dp
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#  include <pthread.h>
+#  include <sched.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+
+#  include <cerrno>
+#  include <system_error>
+#endif
+
+namespace dp {
+  /// @brief NUMA node hint meaning "no preference".
+  inline constexpr int no_numa_node = -1;
+
+  namespace details {
+    /**
+     * @brief Parse a Linux cpu or node list such as "0-3,8,10-11".
+     * @return the listed numbers in order, or an empty list if @p list is malformed.
+     */
+    inline std::vector<unsigned> parse_cpu_list(const std::string &list) {
+      std::vector<unsigned> result;
+      std::size_t position = 0;
+      const auto read_number = [&list, &position](unsigned &value) {
+        const auto start = position;
+        unsigned long number = 0;
+        while (position < list.size() && list[position] >= '0' && list[position] <= '9') {
+          number = number * 10 + static_cast<unsigned long>(list[position] - '0');
+          if (number > std::numeric_limits<unsigned>::max()) return false;
+          ++position;
+        }
+        value = static_cast<unsigned>(number);
+        return position != start;
+      };
+      while (position < list.size() && list[position] != '\n') {
+        unsigned first = 0;
+        if (!read_number(first)) return {};
+        auto last = first;
+        if (position < list.size() && list[position] == '-') {
+          ++position;
+          if (!read_number(last) || last < first) return {};
+        }
+        for (auto cpu = first; cpu <= last; ++cpu) result.push_back(cpu);
+        if (position < list.size() && list[position] == ',') ++position;
+      }
+      return result;
+    }
+
+    inline std::string read_first_line(const std::string &path) {
+      std::ifstream file(path);
+      std::string line;
+      std::getline(file, line);
+      return line;
+    }
+  }  // namespace details
+
+  /**
+   * @brief CPUs of a NUMA node, read from sysfs.
+   * @return an empty list if the node does not exist or the topology is unknown (e.g. on
+   * non-Linux systems).
+   */
+  [[nodiscard]] inline std::vector<unsigned> numa_node_cpus(int node) {
+    if (node < 0) return {};
+    return details::parse_cpu_list(details::read_first_line(
+        "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+  }
+
+  /**
+   * @brief Number of online NUMA nodes; 1 if the topology is unknown.
+   */
+  [[nodiscard]] inline int numa_node_count() {
+    const auto nodes
+        = details::parse_cpu_list(details::read_first_line("/sys/devices/system/node/online"));
+    return nodes.empty() ? 1 : static_cast<int>(nodes.back()) + 1;
+  }
+
+  /**
+   * @brief Restrict @p thread to the CPUs of NUMA node @p node.
+   * @details A hint: returns false, leaving the affinity alone, if the node is unknown or the
+   * platform does not support thread affinity.
+   */
+  inline bool bind_thread_to_numa_node(std::thread::native_handle_type thread, int node) {
+#if defined(__linux__)
+    const auto cpus = numa_node_cpus(node);
+    if (cpus.empty()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const auto cpu : cpus) {
+      if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+#else
+    (void)thread;
+    (void)node;
+    return false;
+#endif
+  }
+
+  inline bool bind_current_thread_to_numa_node(int node) {
+#if defined(__linux__)
+    return bind_thread_to_numa_node(pthread_self(), node);
+#else
+    (void)node;
+    return false;
+#endif
+  }
+
+  /**
+   * @brief Ask the kernel to place the pages of [address, address + size) on NUMA node @p node.
+   * @details Uses the mbind system call directly (no libnuma) with a preferred policy, so the
+   * kernel falls back to other nodes when @p node runs out of memory. @p address must be page
+   * aligned. Returns false where mbind is unavailable, e.g. in containers that filter it.
+   */
+  inline bool bind_memory_to_numa_node(void *address, std::size_t size, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+    constexpr auto bits = std::numeric_limits<unsigned long>::digits;
+    constexpr int max_nodes = 1024;
+    if (node < 0 || node >= max_nodes) return false;
+    unsigned long mask[max_nodes / bits]{};
+    const auto index = static_cast<unsigned>(node);
+    mask[index / bits] = 1UL << (index % bits);
+    // MPOL_PREFERRED, the kernel counts one node less than maxnode
+    constexpr long mpol_preferred = 1;
+    return syscall(SYS_mbind, address, size, mpol_preferred, mask,
+                   static_cast<unsigned long>(max_nodes + 1), 0UL)
+           == 0;
+#else
+    (void)address;
+    (void)size;
+    (void)node;
+    return false;
+#endif
+  }
+
+  /**
+   * @brief Fixed capacity memory arena placed on a NUMA node, for the callback state and job
+   * data that a node bound timer touches on every tick. Nothing in the library allocates from
+   * it; in particular the scheduler's timer records are not placed on a node.
+   * @details The memory is mapped up front, bound to the node with mbind and pre-faulted. Where
+   * mbind is unavailable the pages are first touched by a helper thread bound to the node, which
+   * places them on that node under the default first-touch policy. Allocation is a lock free
+   * bump of an offset; memory is only returned when the arena is destroyed, so the arena must
+   * outlive everything allocated from it.
+   */
+  class numa_arena {
+  public:
+    /**
+     * @throws std::system_error if the memory cannot be mapped.
+     */
+    explicit numa_arena(std::size_t capacity, int node = no_numa_node)
+        : capacity_(capacity), node_(node) {
+#if defined(__linux__)
+      const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+      capacity_ = std::max<std::size_t>((capacity + page - 1) / page * page, page);
+      void *memory = mmap(nullptr, capacity_, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (memory == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "mmap");
+      memory_ = static_cast<std::byte *>(memory);
+      if (node_ != no_numa_node) bound_ = bind_memory_to_numa_node(memory_, capacity_, node_);
+      if (bound_ || node_ == no_numa_node) {
+        touch(page);
+      } else {
+        std::thread([this, page]() {
+          bind_current_thread_to_numa_node(node_);
+          touch(page);
+        }).join();
+      }
+#else
+      fallback_ = std::make_unique<std::byte[]>(capacity_);
+      memory_ = fallback_.get();
+#endif
+    }
+
+    numa_arena(const numa_arena &) = delete;
+    numa_arena &operator=(const numa_arena &) = delete;
+
+    ~numa_arena() {
+#if defined(__linux__)
+      munmap(memory_, capacity_);
+#endif
+    }
+
+    /**
+     * @brief Allocate @p size bytes aligned to @p alignment (a power of two).
+     * @return nullptr once the arena is exhausted.
+     */
+    [[nodiscard]] void *allocate(std::size_t size,
+                                 std::size_t alignment = alignof(std::max_align_t)) noexcept {
+      auto offset = used_.load(std::memory_order_relaxed);
+      std::size_t start = 0;
+      do {
+        start = (offset + alignment - 1) & ~(alignment - 1);
+        if (start > capacity_ || size > capacity_ - start) return nullptr;
+      } while (!used_.compare_exchange_weak(offset, start + size, std::memory_order_relaxed));
+      return memory_ + start;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+    [[nodiscard]] std::size_t used() const noexcept {
+      return used_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] int node() const noexcept { return node_; }
+    /// @brief True if the pages were placed with mbind rather than by first touch.
+    [[nodiscard]] bool bound() const noexcept { return bound_; }
+
+  private:
+    void touch(std::size_t page) noexcept {
+      for (std::size_t offset = 0; offset < capacity_; offset += page) {
+        static_cast<volatile std::byte *>(memory_)[offset] = std::byte{0};
+      }
+    }
+
+    std::size_t capacity_;
+    int node_;
+    bool bound_{false};
+    std::byte *memory_{nullptr};
+    std::atomic<std::size_t> used_{0};
+#if !defined(__linux__)
+    std::unique_ptr<std::byte[]> fallback_{};
+#endif
+  };
+
+  /**
+   * @brief Standard allocator that takes its memory from a numa_arena, e.g. for the buffers of
+   * a memory heavy periodic job. Deallocation is a no-op.
+   */
+  template <typename T> class numa_allocator {
+  public:
+    using value_type = T;
+
+    explicit numa_allocator(numa_arena &arena) noexcept : arena_(&arena) {}
+    template <typename U>
+    numa_allocator(const numa_allocator<U> &other) noexcept : arena_(other.arena()) {}
+
+    [[nodiscard]] T *allocate(std::size_t count) {
+      if (count > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_alloc();
+      auto *memory = arena_->allocate(count * sizeof(T), alignof(T));
+      if (memory == nullptr) throw std::bad_alloc();
+      return static_cast<T *>(memory);
+    }
+    void deallocate(T *, std::size_t) noexcept {}
+
+    [[nodiscard]] numa_arena *arena() const noexcept { return arena_; }
+
+    template <typename U> bool operator==(const numa_allocator<U> &other) const noexcept {
+      return arena_ == other.arena();
+    }
+    template <typename U> bool operator!=(const numa_allocator<U> &other) const noexcept {
+      return arena_ != other.arena();
+    }
+
+  private:
+    numa_arena *arena_;
+  };
+}  // namespace dp
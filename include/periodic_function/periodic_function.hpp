@@ -1,27 +1,175 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <periodic_function/backends.hpp>
+#include <periodic_function/latency_histogram.hpp>
+#include <periodic_function/numa.hpp>
+#include <ratio>
 #include <thread>
 #include <type_traits>
+#include <utility>
 
 namespace dp {
+  /**
+   * @brief Details about the current tick, passed to callbacks that accept a
+   * <tt>const tick_info &</tt> argument.
+   */
+  struct tick_info {
+    /// @brief When the tick was scheduled to run.
+    std::chrono::steady_clock::time_point scheduled_time{};
+    /// @brief When the callback was actually invoked.
+    std::chrono::steady_clock::time_point start_time{};
+    /// @brief Number of previous ticks of this timer.
+    std::uint64_t tick_count{0};
+  };
+
   namespace details {
-    template <class T, typename = void> struct has_default_operator : std::false_type {};
+    template <typename T> using remove_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;
 
-    template <typename T> struct has_default_operator<T, std::void_t<decltype(std::declval<T>()())>>
-        : std::true_type {};
+    template <typename T> struct is_in_place_type : std::false_type {};
+    template <typename T> struct is_in_place_type<std::in_place_type_t<T>> : std::true_type {};
+    template <typename T> inline constexpr bool is_in_place_type_v = is_in_place_type<T>::value;
+
+    /// @brief Whether @p Args is a single argument of type @p Self, i.e. a copy or a move.
+    template <typename Self, typename... Args> struct is_self_argument : std::false_type {};
+    template <typename Self, typename Arg> struct is_self_argument<Self, Arg>
+        : std::is_same<Self, remove_cvref_t<Arg>> {};
+    template <typename Self, typename... Args> inline constexpr bool is_self_argument_v
+        = is_self_argument<Self, Args...>::value;
+
+    template <typename T> inline constexpr bool is_tick_info_callback_v
+        = std::is_invocable_v<T &, const tick_info &>;
+
+    template <typename T> inline constexpr bool is_periodic_callback_v
+        = std::is_invocable_v<T &> || is_tick_info_callback_v<T>;
+
+    template <typename Callback>
+    decltype(auto) call_callback(Callback &callback, const tick_info &info) {
+      if constexpr (is_tick_info_callback_v<Callback>) {
+        return std::invoke(callback, info);
+      } else {
+        return std::invoke(callback);
+      }
+    }
+
+    /**
+     * @brief Invoke a callback and report whether it succeeded.
+     * @details Callbacks returning @c bool signal failure by returning false. All other callbacks
+     * succeed unless they throw.
+     */
+    template <typename Callback> bool invoke_callback(Callback &callback, const tick_info &info) {
+      if constexpr (std::is_same_v<decltype(call_callback(callback, info)), bool>) {
+        return call_callback(callback, info);
+      } else {
+        call_callback(callback, info);
+        return true;
+      }
+    }
+  }  // namespace details
 
-    template <typename T> inline constexpr auto has_default_operator_v
-        = has_default_operator<T>::value;
+  namespace details {
+    /**
+     * @brief Calls a member function, known at compile time, on a stored object pointer.
+     */
+    template <auto Method, typename Object> class bound_member_callback {
+    public:
+      explicit constexpr bound_member_callback(Object *object) noexcept : object_(object) {}
+
+      template <typename... Args> constexpr auto operator()(Args &&...args) const
+          -> decltype((std::declval<Object *>()->*Method)(std::forward<Args>(args)...)) {
+        return (object_->*Method)(std::forward<Args>(args)...);
+      }
 
-    template <typename T> using is_suitable_callback
-        = std::enable_if_t<std::is_invocable_v<T> && details::has_default_operator_v<T>>;
+    private:
+      Object *object_;
+    };
+
+    /**
+     * @brief Calls a member function pointer, stored at run time, on a stored object pointer.
+     */
+    template <typename Method, typename Object> class member_function_callback {
+    public:
+      constexpr member_function_callback(Method method, Object *object) noexcept
+          : method_(method), object_(object) {}
+
+      template <typename... Args> constexpr auto operator()(Args &&...args) const
+          -> decltype((std::declval<Object *>()->*std::declval<Method>())(
+              std::forward<Args>(args)...)) {
+        return (object_->*method_)(std::forward<Args>(args)...);
+      }
+
+    private:
+      Method method_;
+      Object *object_;
+    };
+
+    template <typename Method> struct member_function_class;
+    template <typename Return, typename Class, typename... Args>
+    struct member_function_class<Return (Class::*)(Args...)> {
+      using type = Class;
+    };
+    template <typename Return, typename Class, typename... Args>
+    struct member_function_class<Return (Class::*)(Args...) const> {
+      using type = const Class;
+    };
+    template <typename Return, typename Class, typename... Args>
+    struct member_function_class<Return (Class::*)(Args...) noexcept> {
+      using type = Class;
+    };
+    template <typename Return, typename Class, typename... Args>
+    struct member_function_class<Return (Class::*)(Args...) const noexcept> {
+      using type = const Class;
+    };
   }  // namespace details
 
+  /**
+   * @brief Bind a member function to an object without std::bind.
+   * @details The member function is a template argument, so the call is dispatched at compile time
+   * and can be inlined into the timer loop. Only a pointer to @p object is stored; the object
+   * must outlive the timer.
+   * @code
+   * dp::periodic_function func(dp::bind_member<&sensor::poll>(my_sensor), 100ms);
+   * @endcode
+   */
+  template <auto Method, typename Object> constexpr auto bind_member(Object &object) noexcept {
+    static_assert(std::is_member_function_pointer_v<decltype(Method)>,
+                  "dp::bind_member: Method must be a pointer to member function");
+    static_assert(
+        std::is_base_of_v<std::remove_const_t<
+                              typename details::member_function_class<decltype(Method)>::type>,
+                          std::remove_const_t<Object>>,
+        "dp::bind_member: object is not of the member function's class");
+    return details::bound_member_callback<Method, Object>(&object);
+  }
+
+#if defined(__cpp_concepts) && __cpp_concepts >= 201907L
+  /**
+   * @brief A callable that can be used as a timer callback: invocable with no arguments or with
+   * a <tt>const dp::tick_info &</tt>. Plain functions, function pointers, lambdas and function
+   * objects all qualify.
+   */
+  template <typename T> concept periodic_callback = details::is_periodic_callback_v<T>;
+#endif
+
   namespace policies {
     /// @name Missed interval policies
-    /// @}
+    /// @details schedule(callback_time, interval) is called on the timer thread after every tick
+    /// and returns the time to add to the tick's deadline. Policies are stored per timer, so
+    /// schedule() may be a stateful member function. The callback time is rounded down to whole
+    /// milliseconds unless the policy declares <tt>static constexpr bool precise_callback_time =
+    /// true</tt>. A policy that changes the interval can provide current_interval(interval),
+    /// which is then also used to advance the schedule over skipped ticks.
+    /// @{
     struct schedule_next_missed_interval_policy {
       template <typename TimeType>
       static constexpr TimeType schedule(TimeType callback_time, TimeType interval) {
@@ -48,44 +196,438 @@ namespace dp {
         return TimeType{0};
       }
     };
+
+    /**
+     * @brief Adapt the interval to hold a target duty cycle (callback time / interval).
+     * @details After every tick a bounded PI controller rescales the configured interval: cheap
+     * callbacks shorten it, so the timer polls more often, and overrunning callbacks stretch it.
+     * The scale is clamped to [MinScale, MaxScale] and the integral term stops accumulating while
+     * the output is clamped (anti-windup). Missed intervals are then handled like
+     * schedule_next_missed_interval_policy, using the adapted interval. Callback times are not
+     * rounded, so sub-millisecond callbacks are measured too. The current scale can be read lock
+     * free from any thread.
+     * @tparam TargetDutyCycle std::ratio in (0, 1], e.g. std::ratio<1, 4> for 25%.
+     * @tparam MinScale shortest interval relative to the configured one.
+     * @tparam MaxScale longest interval relative to the configured one.
+     */
+    template <typename TargetDutyCycle = std::ratio<1, 4>, typename MinScale = std::ratio<1, 10>,
+              typename MaxScale = std::ratio<10>>
+    class adaptive_interval_policy {
+      static_assert(TargetDutyCycle::num > 0 && TargetDutyCycle::num <= TargetDutyCycle::den,
+                    "dp::policies::adaptive_interval_policy: the target duty cycle must be in "
+                    "(0, 1]");
+      static_assert(MinScale::num > 0 && std::ratio_less_equal_v<MinScale, std::ratio<1>>
+                        && std::ratio_greater_equal_v<MaxScale, std::ratio<1>>,
+                    "dp::policies::adaptive_interval_policy: scale bounds must satisfy "
+                    "0 < MinScale <= 1 <= MaxScale");
+
+    public:
+      static constexpr double target_duty_cycle
+          = static_cast<double>(TargetDutyCycle::num) / static_cast<double>(TargetDutyCycle::den);
+      static constexpr double min_scale
+          = static_cast<double>(MinScale::num) / static_cast<double>(MinScale::den);
+      static constexpr double max_scale
+          = static_cast<double>(MaxScale::num) / static_cast<double>(MaxScale::den);
+      static constexpr double proportional_gain = 0.5;
+      static constexpr double integral_gain = 0.2;
+      static constexpr bool precise_callback_time = true;
+
+      adaptive_interval_policy() = default;
+      adaptive_interval_policy(const adaptive_interval_policy &other)
+          : integral_(other.integral_), scale_(other.scale()) {}
+      adaptive_interval_policy &operator=(const adaptive_interval_policy &other) {
+        integral_ = other.integral_;
+        scale_.store(other.scale(), std::memory_order_relaxed);
+        return *this;
+      }
+      ~adaptive_interval_policy() = default;
+
+      template <typename TimeType> TimeType schedule(TimeType callback_time, TimeType interval) {
+        const auto current = std::chrono::duration_cast<TimeType>(interval * scale());
+        if (current <= TimeType{0}) {
+          return schedule_next_missed_interval_policy::schedule(callback_time, interval);
+        }
+
+        // relative error of the duty cycle, positive when the callback overran its share
+        const auto duty_cycle = std::chrono::duration<double>(callback_time)
+                                / std::chrono::duration<double>(current);
+        const auto error = duty_cycle / target_duty_cycle - 1.0;
+        const auto integral = integral_ + error;
+        const auto output = 1.0 + proportional_gain * error + integral_gain * integral;
+        if (output > min_scale && output < max_scale) integral_ = integral;
+        scale_.store(std::clamp(output, min_scale, max_scale), std::memory_order_relaxed);
+
+        const auto next = std::chrono::duration_cast<TimeType>(interval * scale());
+        return schedule_next_missed_interval_policy::schedule(callback_time, next);
+      }
+
+      /// @brief Current interval relative to the configured one.
+      [[nodiscard]] double scale() const noexcept {
+        return scale_.load(std::memory_order_relaxed);
+      }
+
+      /// @brief The adapted interval for a timer configured with @p interval.
+      template <typename Rep, typename Period>
+      [[nodiscard]] std::chrono::duration<Rep, Period> current_interval(
+          std::chrono::duration<Rep, Period> interval) const noexcept {
+        return std::chrono::duration_cast<std::chrono::duration<Rep, Period>>(interval * scale());
+      }
+
+    private:
+      double integral_{0.0};
+      std::atomic<double> scale_{1.0};
+    };
+    /// @}
+
+    /// @name Error handling policies
+    /// @details should_invoke() is checked before every tick; returning false skips the tick.
+    /// on_error() is called on the timer thread when the callback throws (from within the catch
+    /// block, so the policy can inspect std::current_exception()) or when a callback returning
+    /// @c bool returns false. Returning false from on_error() stops the timer. on_stop() is called
+    /// from periodic_function::stop() after the timer thread has exited. An optional on_start() is
+    /// called whenever the timer is (re)started, before its timer thread is launched.
+    /// @{
+
+    /**
+     * @brief Suppress all exceptions thrown by the callback (default).
+     */
+    struct ignore_errors_policy {
+      static constexpr bool should_invoke() noexcept { return true; }
+      static constexpr void on_success() noexcept {}
+      static constexpr bool on_error() noexcept { return true; }
+      static constexpr void on_stop() noexcept {}
+    };
+
+    /**
+     * @brief Keep running, but record the most recent exception and count failures.
+     * @details Counters can be read lock free from any thread.
+     */
+    class record_errors_policy {
+    public:
+      record_errors_policy() = default;
+      record_errors_policy(const record_errors_policy &other)
+          : error_count_(other.error_count()),
+            consecutive_errors_(other.consecutive_errors()),
+            last_error_(other.last_error()) {}
+      record_errors_policy &operator=(const record_errors_policy &other) {
+        if (this != &other) {
+          error_count_ = other.error_count();
+          consecutive_errors_ = other.consecutive_errors();
+          auto error = other.last_error();
+          std::lock_guard<std::mutex> lock(error_mutex_);
+          last_error_ = std::move(error);
+        }
+        return *this;
+      }
+      ~record_errors_policy() = default;
+
+      static constexpr bool should_invoke() noexcept { return true; }
+      void on_success() noexcept { consecutive_errors_.store(0, std::memory_order_relaxed); }
+      bool on_error() {
+        error_count_.fetch_add(1, std::memory_order_relaxed);
+        consecutive_errors_.fetch_add(1, std::memory_order_relaxed);
+        // failures reported through a return code have no exception to keep
+        if (auto error = std::current_exception()) {
+          std::lock_guard<std::mutex> lock(error_mutex_);
+          last_error_ = std::move(error);
+        }
+        return true;
+      }
+      static constexpr void on_stop() noexcept {}
+
+      /// @brief Total number of callback invocations that failed.
+      [[nodiscard]] std::uint64_t error_count() const noexcept {
+        return error_count_.load(std::memory_order_relaxed);
+      }
+      /// @brief Number of invocations that failed since the last successful one.
+      [[nodiscard]] std::uint64_t consecutive_errors() const noexcept {
+        return consecutive_errors_.load(std::memory_order_relaxed);
+      }
+      /// @brief The most recent exception thrown by the callback, or nullptr.
+      [[nodiscard]] std::exception_ptr last_error() const {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        return last_error_;
+      }
+
+    protected:
+      void reset_consecutive_errors() noexcept {
+        consecutive_errors_.store(0, std::memory_order_relaxed);
+      }
+
+      std::exception_ptr take_last_error() {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        return std::exchange(last_error_, nullptr);
+      }
+
+    private:
+      std::atomic<std::uint64_t> error_count_{0};
+      std::atomic<std::uint64_t> consecutive_errors_{0};
+      mutable std::mutex error_mutex_{};
+      std::exception_ptr last_error_{};
+    };
+
+    /**
+     * @brief Record errors and stop the timer after @p MaxConsecutiveErrors failures in a row.
+     * @details Restarting the timer starts counting from zero again.
+     */
+    template <std::uint64_t MaxConsecutiveErrors> class stop_on_consecutive_errors_policy
+        : public record_errors_policy {
+      static_assert(MaxConsecutiveErrors > 0);
+
+    public:
+      void on_start() noexcept { reset_consecutive_errors(); }
+
+      bool on_error() {
+        record_errors_policy::on_error();
+        return consecutive_errors() < MaxConsecutiveErrors;
+      }
+    };
+
+    /**
+     * @brief Record errors and rethrow the most recent one from periodic_function::stop().
+     * @details The destructor never throws; an error still pending at destruction is dropped.
+     */
+    class rethrow_on_stop_policy : public record_errors_policy {
+    public:
+      void on_stop() {
+        if (auto error = take_last_error()) std::rethrow_exception(error);
+      }
+    };
+
+    enum class circuit_state : std::uint8_t { closed, open, half_open };
+
+    /**
+     * @brief Stop running a failing callback at full rate.
+     * @details Closed: ticks run normally. After @p FailureThreshold consecutive failures the
+     * circuit opens and ticks are skipped for @p CooldownMilliseconds. The next tick after the
+     * cooldown is a single probe (half open): success closes the circuit, failure re-opens it for
+     * another cooldown. Errors are recorded as with record_errors_policy.
+     */
+    template <std::uint64_t FailureThreshold = 5, std::int64_t CooldownMilliseconds = 30000>
+    class circuit_breaker_policy : public record_errors_policy {
+      static_assert(FailureThreshold > 0);
+      static_assert(CooldownMilliseconds >= 0);
+
+    public:
+      using clock_type = std::chrono::steady_clock;
+      static constexpr std::chrono::milliseconds cooldown{CooldownMilliseconds};
+
+      circuit_breaker_policy() = default;
+      circuit_breaker_policy(const circuit_breaker_policy &other)
+          : record_errors_policy(other),
+            state_(other.state()),
+            times_opened_(other.times_opened()),
+            skipped_ticks_(other.skipped_ticks()),
+            open_until_(other.open_until_) {}
+      circuit_breaker_policy &operator=(const circuit_breaker_policy &other) {
+        if (this != &other) {
+          record_errors_policy::operator=(other);
+          state_ = other.state();
+          times_opened_ = other.times_opened();
+          skipped_ticks_ = other.skipped_ticks();
+          open_until_ = other.open_until_;
+        }
+        return *this;
+      }
+      ~circuit_breaker_policy() = default;
+
+      bool should_invoke() noexcept {
+        // closed is the common case and costs a single relaxed load
+        if (state_.load(std::memory_order_relaxed) != circuit_state::open) return true;
+        if (clock_type::now() < open_until_) {
+          skipped_ticks_.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+        state_.store(circuit_state::half_open, std::memory_order_relaxed);
+        return true;
+      }
+
+      void on_success() noexcept {
+        record_errors_policy::on_success();
+        state_.store(circuit_state::closed, std::memory_order_relaxed);
+      }
+
+      bool on_error() {
+        record_errors_policy::on_error();
+        const auto current = state_.load(std::memory_order_relaxed);
+        if (current == circuit_state::half_open
+            || (current == circuit_state::closed && consecutive_errors() >= FailureThreshold)) {
+          open_until_ = clock_type::now() + cooldown;
+          times_opened_.fetch_add(1, std::memory_order_relaxed);
+          state_.store(circuit_state::open, std::memory_order_relaxed);
+        }
+        return true;
+      }
+
+      [[nodiscard]] circuit_state state() const noexcept {
+        return state_.load(std::memory_order_relaxed);
+      }
+      /// @brief Number of times the circuit has opened.
+      [[nodiscard]] std::uint64_t times_opened() const noexcept {
+        return times_opened_.load(std::memory_order_relaxed);
+      }
+      /// @brief Number of ticks skipped while the circuit was open.
+      [[nodiscard]] std::uint64_t skipped_ticks() const noexcept {
+        return skipped_ticks_.load(std::memory_order_relaxed);
+      }
+
+    private:
+      std::atomic<circuit_state> state_{circuit_state::closed};
+      std::atomic<std::uint64_t> times_opened_{0};
+      std::atomic<std::uint64_t> skipped_ticks_{0};
+      // only touched by the timer thread
+      clock_type::time_point open_until_{};
+    };
     /// @}
   }  // namespace policies
 
+  /**
+   * @brief What an early tick requested with periodic_function::trigger_now() does to the
+   * regular schedule.
+   */
+  enum class trigger_phase : std::uint8_t {
+    /// @brief Regular ticks continue on their original schedule.
+    preserve = 1,
+    /// @brief The next regular tick is one interval after the early tick.
+    reset = 2
+  };
+
+  namespace details {
+    template <typename Policy, typename = void> struct has_precise_callback_time
+        : std::false_type {};
+    template <typename Policy>
+    struct has_precise_callback_time<Policy, std::void_t<decltype(Policy::precise_callback_time)>>
+        : std::bool_constant<Policy::precise_callback_time> {};
+
+    /// @brief The callback time as handed to a missed interval policy's schedule().
+    template <typename Policy, typename TimeType>
+    constexpr TimeType policy_callback_time(TimeType callback_time) noexcept {
+      if constexpr (has_precise_callback_time<Policy>::value) {
+        return callback_time;
+      } else {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(callback_time);
+      }
+    }
+
+    template <typename Policy, typename = void> struct has_on_start : std::false_type {};
+    template <typename Policy>
+    struct has_on_start<Policy, std::void_t<decltype(std::declval<Policy &>().on_start())>>
+        : std::true_type {};
+
+    template <typename Policy, typename TimeType, typename = void> struct has_current_interval
+        : std::false_type {};
+    template <typename Policy, typename TimeType>
+    struct has_current_interval<
+        Policy, TimeType,
+        std::void_t<decltype(std::declval<const Policy &>().current_interval(TimeType{}))>>
+        : std::true_type {};
+
+    /// @brief The interval a missed interval policy currently schedules with.
+    template <typename Policy, typename TimeType>
+    TimeType policy_interval(const Policy &policy, TimeType interval) noexcept {
+      if constexpr (has_current_interval<Policy, TimeType>::value) {
+        return policy.current_interval(interval);
+      } else {
+        return interval;
+      }
+    }
+  }  // namespace details
+
   /**
    * @brief Repeatedly calls a function at a given time interval.
-   * @tparam Callback the callback time (std::function or a lambda)
+   * @tparam Callback the callback type (std::function, a lambda, a function pointer...). It is
+   * called with no arguments, or with a <tt>const tick_info &</tt> if it accepts one.
+   * @tparam MissedIntervalPolicy how to schedule the next call when the callback overruns.
+   * @tparam ErrorPolicy how to handle exceptions thrown by the callback.
+   * @tparam WaitBackend how the timer thread sleeps until the next tick (see dp::backends).
    */
   template <typename Callback,
             typename MissedIntervalPolicy = policies::schedule_next_missed_interval_policy,
-            typename = details::is_suitable_callback<Callback>>
+            typename ErrorPolicy = policies::ignore_errors_policy,
+            typename WaitBackend = backends::condition_variable_backend>
+#if defined(__cpp_concepts) && __cpp_concepts >= 201907L
+    requires periodic_callback<Callback>
+#endif
   class periodic_function final {
+#if !defined(__cpp_concepts) || __cpp_concepts < 201907L
+    static_assert(details::is_periodic_callback_v<Callback>,
+                  "dp::periodic_function: Callback must be callable as f() or f(dp::tick_info)");
+#endif
+
   public:
     using clock_type = std::chrono::steady_clock;
     using time_type = clock_type::duration;
 
-    periodic_function(Callback &&callback, const time_type &interval) noexcept
-        : interval_(interval), callback_(std::forward<Callback>(callback)) {}
-    template <typename ReturnType>
+    /**
+     * @brief Create a timer from any callable (lvalue or rvalue) that Callback can be constructed
+     * from. Lvalues are copied, rvalues are moved.
+     */
+    template <typename Function,
+              typename = std::enable_if_t<
+                  !std::is_same_v<details::remove_cvref_t<Function>, periodic_function>
+                  && !details::is_in_place_type_v<details::remove_cvref_t<Function>>
+                  && std::is_constructible_v<Callback, Function &&>>>
+    periodic_function(Function &&callback, const time_type &interval) noexcept(
+        std::is_nothrow_constructible_v<Callback, Function &&>)
+        : interval_(interval), callback_(std::forward<Function>(callback)) {}
+
+    /**
+     * @brief Construct the callback in place from @p args.
+     * @code
+     * dp::periodic_function func(std::in_place_type<flusher>, 1s, buffer_size);
+     * @endcode
+     */
+    template <typename... Args,
+              typename = std::enable_if_t<std::is_constructible_v<Callback, Args &&...>>>
+    periodic_function(std::in_place_type_t<Callback>, const time_type &interval, Args &&...args)
+        : interval_(interval), callback_(std::forward<Args>(args)...) {}
+
+    /**
+     * @brief Construct the callback in place from @p args, with Callback given explicitly.
+     * @details The callback is built directly in its final storage: it is never moved, so
+     * callbacks that are neither copyable nor movable are supported (such a periodic_function
+     * cannot be moved either).
+     * @code
+     * dp::periodic_function<flusher> func(std::in_place, 1s, buffer_size);
+     * @endcode
+     */
+    template <typename... Args,
+              typename = std::enable_if_t<std::is_constructible_v<Callback, Args &&...>>>
+    periodic_function(std::in_place_t, const time_type &interval, Args &&...args)
+        : interval_(interval), callback_(std::forward<Args>(args)...) {}
+
+    /**
+     * @brief Call a member function of @p object, without the indirection of std::bind.
+     * @details Only a pointer to @p object is stored; the object must outlive the timer.
+     * For compile time dispatch of the member function use dp::bind_member instead.
+     */
+    template <typename Method, typename Object,
+              typename = std::enable_if_t<std::is_member_function_pointer_v<Method>
+                                          && std::is_constructible_v<Callback, Method, Object *>>>
+    periodic_function(Method method, Object *object, const time_type &interval) noexcept
+        : interval_(interval), callback_(method, object) {}
 
     periodic_function(const periodic_function &other) = delete;
     periodic_function(periodic_function &&other) noexcept
-        : interval_(other.interval_), callback_(std::move(other.callback_)) {
-      if (other.is_running()) {
-        other.stop();
-        start();
-      }
-    }
-    ~periodic_function() { stop(); }
+        : periodic_function(std::move(other), moved_from{other.stop_internal()}) {}
+    ~periodic_function() { stop_internal(); }
 
     periodic_function &operator=(const periodic_function &other) = delete;
     periodic_function &operator=(periodic_function &&other) noexcept {
       if (this != &other) {
+        // neither timer thread may use the policies or callbacks while they are moved
+        stop_internal();
+        const auto was_running = other.stop_internal();
         interval_ = other.interval_;
+        error_policy_ = std::move(other.error_policy_);
+        interval_policy_ = std::move(other.interval_policy_);
+        set_trigger_spacing(other.trigger_spacing());
+        attach_stats(other.stats_.load(std::memory_order_acquire));
+        set_numa_node(other.numa_node());
+        pending_callback_ = other.take_pending_callback();
+        callback_pending_ = pending_callback_ != nullptr;
         callback_ = std::move(other.callback_);
-        if (other.is_running()) {
-          other.stop();
-          start();
-        }
+        if (was_running) start();
       }
       return *this;
     }
@@ -94,83 +636,498 @@ namespace dp {
      * @brief Start calling the callback function.
      * @details If the callback is running already, calling start again will stop any existing
      * callback execution and will restart it. This may result in the callback being called with a
-     * shorter time interval than expected.
+     * shorter time interval than expected. Safe to call concurrently with start(), stop() and
+     * is_running() from other threads; if another thread is already starting the timer, this
+     * waits for it and returns.
      */
-    void start() { start_internal(); }
+    void start() {
+      auto current = state_.load(std::memory_order_acquire);
+      while (true) {
+        switch (current) {
+          case run_state::idle:
+            if (state_.compare_exchange_weak(current, run_state::starting,
+                                             std::memory_order_acq_rel)) {
+              launch_runner();
+              return;
+            }
+            break;
+          case run_state::running:
+          case run_state::finished:
+            // restart: claim the runner, join it and launch a new one
+            if (state_.compare_exchange_weak(current, run_state::stopping,
+                                             std::memory_order_acq_rel)) {
+              join_runner();
+              set_state(run_state::starting);
+              launch_runner();
+              return;
+            }
+            break;
+          case run_state::starting:
+            current = wait_while(run_state::starting);
+            if (current == run_state::running) return;
+            break;
+          case run_state::stopping:
+            current = wait_while(run_state::stopping);
+            break;
+        }
+      }
+    }
 
     /**
      * @brief Stop calling the callback function if the timer is running.
+     * @details The error policy's on_stop() is called afterwards, which may rethrow an exception
+     * captured from the callback (see policies::rethrow_on_stop_policy). Safe to call
+     * concurrently with start(), stop() and is_running() from other threads, but not from the
+     * callback itself.
      */
     void stop() {
+      stop_internal();
+      error_policy_.on_stop();
+    }
+
+    /**
+     * @brief Returns a boolean to indicate if the timer is running.
+     * @details This is false once the error policy has stopped the timer, and while another
+     * thread is starting or stopping it. Lock free.
+     * @return true if the timer is running, false otherwise.
+     */
+    [[nodiscard]] bool is_running() const noexcept {
+      return state_.load(std::memory_order_acquire) == run_state::running;
+    }
+
+    /**
+     * @brief Run the callback as soon as possible instead of waiting for the next tick.
+     * @details Wakes the timer thread, which ticks early unless the previous tick started less
+     * than trigger_spacing() ago, in which case the early tick is delayed until the spacing has
+     * passed (or the regular tick is due). Triggers arriving before the early tick runs are
+     * coalesced into it; if any of them asked for trigger_phase::reset, the phase is reset. This
+     * is lock free while a trigger is already pending and otherwise costs one wake() of the wait
+     * backend. Has no effect if the timer is not running.
+     */
+    void trigger_now(trigger_phase phase = trigger_phase::preserve) {
+      // a wake latched now would cut the first wait of the next start() short
+      if (!is_running()) return;
+      const auto previous
+          = trigger_.fetch_or(static_cast<std::uint8_t>(phase), std::memory_order_acq_rel);
+      // the timer thread has not consumed the pending trigger yet, it will see this one too
+      if (previous != 0) return;
+      // wakeups are latched, so this cannot be lost even if the timer thread is not waiting yet
+      backend_.wake();
+    }
+
+    /**
+     * @brief Set the minimum time between the start of a tick and an early tick following it.
+     */
+    void set_trigger_spacing(const time_type &spacing) noexcept {
+      trigger_spacing_.store(spacing.count(), std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] time_type trigger_spacing() const noexcept {
+      return time_type{trigger_spacing_.load(std::memory_order_relaxed)};
+    }
+
+    /**
+     * @brief Run the timer thread on the CPUs of NUMA node @p node (or dp::no_numa_node).
+     * @details Takes effect the next time the timer is started. The timer thread binds itself
+     * before its first tick, so memory the callback first touches from then on is placed on the
+     * node; state allocated up front can be placed there with a dp::numa_arena. A node that does
+     * not exist is ignored.
+     */
+    void set_numa_node(int node) noexcept { numa_node_.store(node, std::memory_order_relaxed); }
+
+    [[nodiscard]] int numa_node() const noexcept {
+      return numa_node_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Record callback execution time and wakeup lateness into @p stats.
+     * @details The timer thread records one value per histogram and tick, each a relaxed atomic
+     * increment, so @p stats can be read (or merged and serialized) while the timer runs. Pass
+     * nullptr to detach. The stats must outlive the timer or stay attached only while valid; a
+     * tick that is running while detaching may still record into the old stats.
+     */
+    void attach_stats(timer_stats *stats) noexcept {
+      stats_.store(stats, std::memory_order_release);
+    }
+
+    /**
+     * @brief Access the error policy, e.g. to read recorded error counts.
+     */
+    [[nodiscard]] const ErrorPolicy &error_policy() const noexcept { return error_policy_; }
+
+    /**
+     * @brief Access the missed interval policy, e.g. to read the adapted interval.
+     */
+    [[nodiscard]] const MissedIntervalPolicy &interval_policy() const noexcept {
+      return interval_policy_;
+    }
+
+    /**
+     * @brief The configured interval.
+     */
+    [[nodiscard]] time_type interval() const noexcept { return interval_; }
+
+    /**
+     * @brief Replace the callback without stopping the timer.
+     * @details While running, the new callable is handed to the timer thread, which swaps it in
+     * between ticks; the timer thread is the only user of the callback, so the old callable is
+     * reclaimed there without any tick still using it. The schedule (and phase) of the timer is
+     * not affected. The cost for ticks when no replacement is pending is one atomic load.
+     * Requires a move assignable callback type, such as std::function.
+     */
+    template <typename NewCallback> void replace_callback(NewCallback &&callback) {
+      static_assert(std::is_constructible_v<Callback, NewCallback &&> && replaceable_callback,
+                    "dp::periodic_function: replace_callback requires an assignable callback "
+                    "type (e.g. std::function) constructible from the new callable");
+      auto replacement = std::make_unique<Callback>(std::forward<NewCallback>(callback));
+      std::unique_ptr<Callback> retired{};
       {
-        std::unique_lock<mutex_type> lock(stop_cv_mutex_);
-        stop_ = true;
+        std::lock_guard<mutex_type> lock(replace_mutex_);
+        retired = std::exchange(pending_callback_, std::move(replacement));
+        callback_pending_.store(true, std::memory_order_release);
       }
-      stop_condition_.notify_one();
-      // ensure that the thread exits.
-      if (runner_.joinable()) {
-        runner_.join();
+      // nobody else is using the callback, claim the idle timer and swap it right away.
+      // otherwise the timer thread (or the next start) picks it up
+      auto expected = run_state::idle;
+      if (state_.compare_exchange_strong(expected, run_state::starting,
+                                         std::memory_order_acq_rel)) {
+        apply_pending_callback();
+        set_state(run_state::idle);
       }
-      {
-        // reset stop condition
-        std::unique_lock<mutex_type> lock(stop_cv_mutex_);
-        stop_ = false;
+    }
+
+  private:
+    /// @brief Whether the timer moved from was running before it was stopped for the move.
+    struct moved_from {
+      bool was_running;
+    };
+
+    /// @brief Move constructor body, run after @p other has been stopped.
+    periodic_function(periodic_function &&other, moved_from moved) noexcept
+        : interval_(other.interval_),
+          error_policy_(std::move(other.error_policy_)),
+          interval_policy_(std::move(other.interval_policy_)),
+          trigger_spacing_(other.trigger_spacing_.load(std::memory_order_relaxed)),
+          stats_(other.stats_.load(std::memory_order_acquire)),
+          numa_node_(other.numa_node()),
+          pending_callback_(other.take_pending_callback()),
+          callback_(std::move(other.callback_)) {
+      callback_pending_ = pending_callback_ != nullptr;
+      if (moved.was_running) start();
+    }
+
+    /**
+     * @brief Life cycle of the timer thread.
+     * @details idle -> starting -> running -> stopping -> idle. A thread that wins the
+     * compare-exchange out of idle or running owns runner_ until it publishes the next stable
+     * state; everybody else waits on the transient starting/stopping states. finished means the
+     * error policy ended the timer thread, which still has to be joined.
+     */
+    enum class run_state : std::uint8_t { idle, starting, running, finished, stopping };
+
+    void set_state(run_state state) noexcept {
+      state_.store(state, std::memory_order_release);
+#if defined(__cpp_lib_atomic_wait) && __cpp_lib_atomic_wait >= 201907L
+      state_.notify_all();
+#endif
+    }
+
+    run_state wait_while(run_state transient) const noexcept {
+      auto current = state_.load(std::memory_order_acquire);
+      while (current == transient) {
+#if defined(__cpp_lib_atomic_wait) && __cpp_lib_atomic_wait >= 201907L
+        state_.wait(current, std::memory_order_acquire);
+#else
+        std::this_thread::yield();
+#endif
+        current = state_.load(std::memory_order_acquire);
+      }
+      return current;
+    }
+
+    /// @brief Called by the timer thread when the error policy ends it.
+    void mark_finished() noexcept {
+      auto expected = run_state::running;
+      while (!state_.compare_exchange_weak(expected, run_state::finished,
+                                           std::memory_order_acq_rel)) {
+        // a stopping thread joins us; nothing left to publish
+        if (expected == run_state::stopping) return;
+        // the launching thread publishes running right after creating this thread
+        if (expected == run_state::starting) std::this_thread::yield();
+        expected = run_state::running;
+      }
+#if defined(__cpp_lib_atomic_wait) && __cpp_lib_atomic_wait >= 201907L
+      state_.notify_all();
+#endif
+    }
+    static constexpr bool replaceable_callback = std::is_move_assignable_v<Callback>;
+
+    std::unique_ptr<Callback> take_pending_callback() {
+      std::lock_guard<mutex_type> lock(replace_mutex_);
+      callback_pending_.store(false, std::memory_order_relaxed);
+      return std::move(pending_callback_);
+    }
+
+    void apply_pending_callback() {
+      if constexpr (replaceable_callback) {
+        if (auto replacement = take_pending_callback()) callback_ = std::move(*replacement);
       }
     }
 
     /**
-     * @brief Returns a boolean to indicate if the timer is running.
-     * @return true if the timer is running, false otherwise.
+     * @brief Stop and join the timer thread.
+     * @return true if the timer was running, false if it was idle or ended by the error policy.
      */
-    [[nodiscard]] bool is_running() const { return runner_.joinable(); }
+    bool stop_internal() {
+      auto current = state_.load(std::memory_order_acquire);
+      while (true) {
+        switch (current) {
+          case run_state::idle:
+            return false;
+          case run_state::running:
+          case run_state::finished:
+            if (state_.compare_exchange_weak(current, run_state::stopping,
+                                             std::memory_order_acq_rel)) {
+              join_runner();
+              set_state(run_state::idle);
+              return current == run_state::running;
+            }
+            break;
+          case run_state::starting:
+            current = wait_while(run_state::starting);
+            break;
+          case run_state::stopping:
+            // another stop or a restart, check again once it is done
+            current = wait_while(run_state::stopping);
+            break;
+        }
+      }
+    }
 
-  private:
-    void start_internal() {
-      if (is_running()) stop();
-      runner_ = std::thread([this]() {
-        const auto thread_start = clock_type::now();
-        // pre-calculate time
-        auto future_time = thread_start + interval_;
-
-        while (true) {
-          // sleep first
-          {
-            std::unique_lock<mutex_type> lock(stop_cv_mutex_);
-            stop_condition_.wait_until(lock, future_time, [&]() -> bool { return stop_; });
-            // check for stoppage here while in the scope of the lock
-            if (stop_) break;
-          }
+    /// @brief Only called by the thread that moved the state to stopping.
+    void join_runner() {
+      stop_.store(true, std::memory_order_release);
+      backend_.wake();
+      // ensure that the thread exits.
+      runner_.join();
+      // reset stop condition
+      stop_.store(false, std::memory_order_relaxed);
+    }
+
+    /// @brief Only called by the thread that moved the state to starting.
+    void launch_runner() {
+      apply_pending_callback();
+      if constexpr (details::has_on_start<ErrorPolicy>::value) error_policy_.on_start();
+      trigger_.store(0, std::memory_order_relaxed);
+      // arm the first tick before handing the backend to the timer thread
+      const auto thread_start = backend_.now();
+      backend_.arm(thread_start + interval_);
+      try {
+        runner_ = std::thread([this, thread_start]() { run(thread_start); });
+      } catch (...) {
+        set_state(run_state::idle);
+        throw;
+      }
+      set_state(run_state::running);
+    }
+
+    /**
+     * @brief Sleep until @p deadline, or until a trigger arrives if @p wake_on_trigger is set.
+     * @return false if the timer is being stopped.
+     */
+    bool sleep_until(const clock_type::time_point &deadline, bool wake_on_trigger) {
+      backend_.arm(deadline);
+      while (!stop_.load(std::memory_order_acquire)) {
+        if (wake_on_trigger && trigger_.load(std::memory_order_acquire) != 0) return true;
+        if (backend_.wait() == wait_status::expired) {
+          return !stop_.load(std::memory_order_acquire);
+        }
+      }
+      return false;
+    }
+
+    void run(clock_type::time_point thread_start) {
+      if (const auto node = numa_node(); node != no_numa_node) {
+        bind_current_thread_to_numa_node(node);
+      }
+      // pre-calculate time
+      auto future_time = thread_start + interval_;
+      // empty until the first tick, whose start is not limited by the trigger spacing
+      std::optional<clock_type::time_point> last_tick{};
+      std::uint64_t tick_count = 0;
+
+      while (true) {
+        // sleep first
+        if (!sleep_until(future_time, true)) break;
+        // rate limit early ticks
+        if (last_tick) {
+          const auto earliest = std::min(*last_tick + trigger_spacing(), future_time);
+          if (backend_.now() < earliest && !sleep_until(earliest, false)) break;
+        }
+
+        const auto trigger = trigger_.exchange(0, std::memory_order_acq_rel);
+        const auto early = trigger != 0 && backend_.now() < future_time;
 
-          // execute the callback and measure execution time
-          const auto callback_start = clock_type::now();
-          // suppress exceptions
-          try {
-            callback_();
-          } catch (...) {
+        // swap in a replaced callback between ticks
+        if constexpr (replaceable_callback) {
+          if (callback_pending_.load(std::memory_order_acquire)) apply_pending_callback();
+        }
+
+        if (!error_policy_.should_invoke()) {
+          // skip this tick, e.g. while a circuit breaker is open
+          if (!early) future_time += details::policy_interval(interval_policy_, interval_);
+          continue;
+        }
+
+        // execute the callback and measure execution time
+        const auto callback_start = backend_.now();
+        const tick_info info{early ? callback_start : future_time, callback_start, tick_count++};
+        last_tick = callback_start;
+        // let the error policy decide what happens to failures
+        auto keep_running = true;
+        try {
+          if (details::invoke_callback(callback_, info)) {
+            error_policy_.on_success();
+          } else {
+            keep_running = error_policy_.on_error();
           }
-          const auto callback_end = clock_type::now();
-          const time_type callback_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-              callback_end - callback_start);
-          const time_type append_time
-              = MissedIntervalPolicy::schedule(callback_duration, interval_);
-          future_time += append_time;
+        } catch (...) {
+          keep_running = error_policy_.on_error();
+        }
+        const auto callback_end = backend_.now();
+        if (auto *stats = stats_.load(std::memory_order_acquire); stats != nullptr) {
+          stats->execution.record(callback_end - callback_start);
+          if (!early) stats->lateness.record(callback_start - future_time);
         }
-      });
+        if (!keep_running) {
+          mark_finished();
+          break;
+        }
+        const auto callback_duration
+            = details::policy_callback_time<MissedIntervalPolicy>(callback_end - callback_start);
+        if (early) {
+          // an early tick leaves the schedule alone unless asked to reset the phase
+          if ((trigger & static_cast<std::uint8_t>(trigger_phase::reset)) == 0) continue;
+          future_time = callback_start;
+        }
+        const time_type append_time = interval_policy_.schedule(callback_duration, interval_);
+        future_time += append_time;
+      }
+      backend_.cancel();
     }
 
     using mutex_type = std::mutex;
-    mutex_type stop_cv_mutex_{};
+    WaitBackend backend_{};
     std::thread runner_{};
     std::atomic_bool stop_ = false;
-    std::condition_variable stop_condition_{};
+    std::atomic<run_state> state_{run_state::idle};
     time_type interval_{100};
+    ErrorPolicy error_policy_{};
+    MissedIntervalPolicy interval_policy_{};
+    std::atomic<std::uint8_t> trigger_{0};
+    std::atomic<time_type::rep> trigger_spacing_{0};
+    std::atomic<timer_stats *> stats_{nullptr};
+    std::atomic<int> numa_node_{no_numa_node};
+    mutex_type replace_mutex_{};
+    std::atomic_bool callback_pending_ = false;
+    std::unique_ptr<Callback> pending_callback_{};
     Callback callback_;
   };
 
   /// @name CTAD guides
   /// @{
-  template <typename ReturnType> periodic_function(ReturnType (*)())
-      -> periodic_function<ReturnType (*)()>;
+  template <typename Function, typename Rep, typename Period,
+            typename = std::enable_if_t<
+                !details::is_in_place_type_v<details::remove_cvref_t<Function>>>>
+  periodic_function(Function &&, std::chrono::duration<Rep, Period>)
+      -> periodic_function<std::decay_t<Function>>;
+  template <typename Function, typename Rep, typename Period, typename... Args>
+  periodic_function(std::in_place_type_t<Function>, std::chrono::duration<Rep, Period>, Args &&...)
+      -> periodic_function<Function>;
+  template <typename Method, typename Object, typename Rep, typename Period,
+            typename = std::enable_if_t<std::is_member_function_pointer_v<Method>>>
+  periodic_function(Method, Object *, std::chrono::duration<Rep, Period>)
+      -> periodic_function<details::member_function_callback<Method, Object>>;
   /// @}
 
+  /**
+   * @brief Drop-in replacement for periodic_function that is compiled out entirely.
+   * @details Construction, start() and stop() are no-ops. No thread, mutex or callback storage is
+   * kept, so the object is empty.
+   * @tparam Callback the callback type that would have been used, likewise the policies and
+   * backend. Accessors return default constructed policies.
+   */
+  template <typename Callback,
+            typename MissedIntervalPolicy = policies::schedule_next_missed_interval_policy,
+            typename ErrorPolicy = policies::ignore_errors_policy,
+            typename WaitBackend = backends::condition_variable_backend>
+  class disabled_periodic_function final {
+  public:
+    using clock_type = std::chrono::steady_clock;
+    using time_type = clock_type::duration;
+
+    template <typename... Args,
+              typename = std::enable_if_t<
+                  !details::is_self_argument_v<disabled_periodic_function, Args...>>>
+    constexpr explicit disabled_periodic_function(Args &&...) noexcept {}
+
+    // not copyable, like periodic_function
+    disabled_periodic_function(const disabled_periodic_function &) = delete;
+    disabled_periodic_function &operator=(const disabled_periodic_function &) = delete;
+    constexpr disabled_periodic_function(disabled_periodic_function &&) noexcept = default;
+    constexpr disabled_periodic_function &operator=(disabled_periodic_function &&) noexcept
+        = default;
+
+    constexpr void start() noexcept {}
+    constexpr void stop() noexcept {}
+    constexpr void trigger_now(trigger_phase = trigger_phase::preserve) noexcept {}
+    constexpr void set_trigger_spacing(const time_type &) noexcept {}
+    [[nodiscard]] constexpr time_type trigger_spacing() const noexcept {
+      return time_type::zero();
+    }
+    constexpr void attach_stats(timer_stats *) noexcept {}
+    constexpr void set_numa_node(int) noexcept {}
+    [[nodiscard]] constexpr int numa_node() const noexcept { return no_numa_node; }
+    [[nodiscard]] constexpr bool is_running() const noexcept { return false; }
+
+    template <typename NewCallback> constexpr void replace_callback(NewCallback &&) noexcept {}
+
+    [[nodiscard]] const ErrorPolicy &error_policy() const noexcept {
+      static const ErrorPolicy policy{};
+      return policy;
+    }
+
+    [[nodiscard]] const MissedIntervalPolicy &interval_policy() const noexcept {
+      static const MissedIntervalPolicy policy{};
+      return policy;
+    }
+
+    /// @brief No interval is stored, so this is always zero.
+    [[nodiscard]] constexpr time_type interval() const noexcept { return time_type::zero(); }
+  };
+
+  /**
+   * @brief Select periodic_function or disabled_periodic_function at compile time.
+   * @tparam Enabled when false, the timer and all of its members are compiled out.
+   */
+  template <bool Enabled, typename Callback, typename... Policies> using periodic_function_if
+      = std::conditional_t<Enabled, periodic_function<Callback, Policies...>,
+                           disabled_periodic_function<Callback, Policies...>>;
+
+  /**
+   * @brief Create a periodic_function_if, deducing the callback type.
+   * @code
+   * constexpr bool debug_stats = false;
+   * auto dumper = dp::make_periodic_function<debug_stats>([] { dump_stats(); }, 1s);
+   * dumper.start();  // no-op when debug_stats is false
+   * @endcode
+   */
+  template <bool Enabled, typename... Policies, typename Callback, typename Rep, typename Period>
+  auto make_periodic_function(Callback &&callback,
+                              const std::chrono::duration<Rep, Period> &interval) {
+    using callback_type = std::decay_t<Callback>;
+    return periodic_function_if<Enabled, callback_type, Policies...>(
+        std::forward<Callback>(callback), interval);
+  }
+
 }  // namespace dp
@@ -0,0 +1,762 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <periodic_function/backends.hpp>
+#include <periodic_function/numa.hpp>
+#include <periodic_function/periodic_function.hpp>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <time.h>
+#endif
+
+namespace dp {
+  /**
+   * @brief Dispatch priority classes for timers sharing a scheduler. Lower values run first.
+   */
+  enum class priority : std::uint8_t { critical = 0, high, normal, low };
+
+  inline constexpr std::size_t priority_count = 4;
+
+  /**
+   * @brief Identifies a timer registered with a scheduler. 0 is never a valid id.
+   */
+  using timer_id = std::uint64_t;
+
+  /**
+   * @brief Identifies a timer group created with scheduler::add_group(). 0 means no group.
+   */
+  using group_id = std::uint64_t;
+
+  struct timer_options {
+    dp::priority priority{priority::normal};
+    /**
+     * @brief Optional owner of the state the callback uses, e.g. a shared_ptr to the object a
+     * member function is bound to. The dispatcher locks it for the duration of each tick and
+     * drops the timer once it has expired, so the callback never runs on a destroyed owner.
+     */
+    std::weak_ptr<const void> lifetime{};
+    /// @brief Group whose CPU budget this timer counts against, see scheduler::add_group().
+    group_id group{0};
+  };
+
+  /**
+   * @brief Combined CPU budget of a group of timers, e.g. 50ms per 1s for 5% of one core.
+   */
+  struct group_options {
+    std::chrono::nanoseconds period{std::chrono::seconds{1}};
+    std::chrono::nanoseconds cpu_budget{std::chrono::milliseconds{50}};
+  };
+
+  struct group_stats {
+    /// @brief CPU time used by the group's callbacks in total.
+    std::chrono::nanoseconds cpu_time{0};
+    /// @brief Wall time spent in the group's callbacks in total.
+    std::chrono::nanoseconds wall_time{0};
+    /// @brief CPU time used in the current budget period.
+    std::chrono::nanoseconds period_cpu_time{0};
+    /// @brief Number of ticks pushed back to the next period because the budget was used up.
+    std::uint64_t deferred{0};
+  };
+
+  struct scheduler_options {
+    /**
+     * @brief Ready timers are promoted one priority class for every multiple of this time they
+     * have waited past their deadline. Zero disables aging (strict priority order).
+     */
+    std::chrono::nanoseconds aging_threshold{0};
+    /**
+     * @brief Run the dispatcher thread on the CPUs of this NUMA node, e.g. one scheduler per
+     * node for callbacks that work on node local data. dp::no_numa_node leaves it unbound.
+     */
+    int numa_node{no_numa_node};
+    /**
+     * @brief Do not start a dispatcher thread. Due timers only run when the owner calls
+     * scheduler::run_due() or scheduler::poll(), e.g. from a busy polling loop on a dedicated
+     * core.
+     */
+    bool polling{false};
+  };
+
+  /**
+   * @brief Wakeup lateness (callback start - deadline) for one priority class.
+   */
+  struct priority_class_stats {
+    std::uint64_t dispatched{0};
+    std::chrono::nanoseconds total_lateness{0};
+    std::chrono::nanoseconds max_lateness{0};
+
+    [[nodiscard]] std::chrono::nanoseconds mean_lateness() const noexcept {
+      return dispatched == 0 ? std::chrono::nanoseconds{0}
+                             : total_lateness / static_cast<std::int64_t>(dispatched);
+    }
+  };
+
+  struct scheduler_stats {
+    std::array<priority_class_stats, priority_count> classes{};
+    /// @brief Number of times the dispatcher thread returned from sleeping.
+    std::uint64_t wakeups{0};
+    /// @brief Number of timers dropped because their lifetime token expired.
+    std::uint64_t expired{0};
+
+    [[nodiscard]] const priority_class_stats &operator[](dp::priority level) const noexcept {
+      return classes[static_cast<std::size_t>(level)];
+    }
+  };
+
+  namespace details {
+    /**
+     * @brief CPU time consumed by the calling thread, or wall time where the platform does not
+     * provide a per-thread CPU clock.
+     */
+    inline std::chrono::nanoseconds thread_cpu_time() noexcept {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+      timespec now{};
+      if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) == 0) {
+        return std::chrono::seconds{now.tv_sec} + std::chrono::nanoseconds{now.tv_nsec};
+      }
+#endif
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch());
+    }
+
+    class timer_node {
+    public:
+      using clock_type = std::chrono::steady_clock;
+
+      timer_node(timer_id id, clock_type::duration interval, const timer_options &options)
+          : id_(id),
+            interval_(interval),
+            options_(options),
+            tracks_lifetime_(options.lifetime.owner_before(std::weak_ptr<const void>{})
+                             || std::weak_ptr<const void>{}.owner_before(options.lifetime)) {}
+      timer_node(const timer_node &) = delete;
+      timer_node &operator=(const timer_node &) = delete;
+      virtual ~timer_node() = default;
+
+      virtual void invoke(const tick_info &info) = 0;
+
+      [[nodiscard]] timer_id id() const noexcept { return id_; }
+      [[nodiscard]] clock_type::duration interval() const noexcept { return interval_; }
+      [[nodiscard]] const timer_options &options() const noexcept { return options_; }
+      [[nodiscard]] std::size_t priority_index() const noexcept {
+        return static_cast<std::size_t>(options_.priority);
+      }
+      /// @brief true if a lifetime token was given, even if it has expired since.
+      [[nodiscard]] bool tracks_lifetime() const noexcept { return tracks_lifetime_; }
+
+      clock_type::time_point deadline{};
+      std::uint64_t tick_count{0};
+      bool removed{false};
+      /// @brief Set when wake_at() moved the deadline while the callback was running.
+      bool rescheduled{false};
+      /// @brief Pending callback replacement, swapped in once the running callback returns.
+      std::unique_ptr<timer_node> replacement{};
+
+    private:
+      timer_id id_;
+      clock_type::duration interval_;
+      timer_options options_;
+      bool tracks_lifetime_;
+    };
+
+    template <typename Callback> class timer_impl final : public timer_node {
+    public:
+      template <typename... Args>
+      timer_impl(timer_id id, clock_type::duration interval, const timer_options &options,
+                 Args &&...args)
+          : timer_node(id, interval, options), callback_(std::forward<Args>(args)...) {}
+
+      void invoke(const tick_info &info) override { details::call_callback(callback_, info); }
+
+    private:
+      Callback callback_;
+    };
+  }  // namespace details
+
+  /**
+   * @brief Runs many periodic timers on a single dispatcher thread.
+   * @details Due timers are moved into per-priority ready queues and dispatched one callback at
+   * a time in strict priority order, so a burst of low priority callbacks cannot delay a critical
+   * timer that falls due at the same instant by more than the callback that is already running.
+   * Optional aging (see scheduler_options) lets long waiting timers overtake higher classes.
+   * Exceptions thrown by callbacks are suppressed. Missed intervals are skipped, as with
+   * policies::schedule_next_missed_interval_policy.
+   *
+   * The dispatcher is tickless: it sleeps exactly until the earliest deadline and never polls.
+   * Adding a timer only wakes it when the new deadline is earlier than the one it is sleeping
+   * until, so an idle scheduler does not wake up at all.
+   *
+   * Timers registered with a timer_options::lifetime token do not need to be removed before
+   * their owner is destroyed: a timer whose token has expired is dropped the next time it falls
+   * due, without invoking the callback.
+   *
+   * Timers can share a CPU budget per period through a group (see add_group()). While a group
+   * has used up its budget, its non-critical timers are deferred to the start of the next
+   * period; critical timers keep running but still count against the budget. CPU time is
+   * measured with the per-thread CPU clock where available (wall time otherwise), and only for
+   * grouped timers.
+   *
+   * @tparam WaitBackend how the dispatcher sleeps until the next deadline (see dp::backends).
+   * Deadlines and tick times are read from the backend's clock, so the scheduler runs on
+   * dp::simulated_clock with backends::simulated_backend.
+   */
+  template <typename WaitBackend = backends::condition_variable_backend>
+  class basic_scheduler final {
+  public:
+    using clock_type = std::chrono::steady_clock;
+    using time_type = clock_type::duration;
+    using time_point = clock_type::time_point;
+
+    explicit basic_scheduler(const scheduler_options &options = {}) : options_(options) {
+      if (options.polling) return;
+      // arm before handing the backend to the dispatcher, which owns it from then on
+      backend_.arm(time_point::max());
+      dispatcher_ = std::thread([this]() { run(); });
+    }
+
+    basic_scheduler(const basic_scheduler &) = delete;
+    basic_scheduler &operator=(const basic_scheduler &) = delete;
+
+    ~basic_scheduler() {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stop_ = true;
+      }
+      backend_.wake();
+      if (dispatcher_.joinable()) dispatcher_.join();
+    }
+
+    /**
+     * @brief The current time of the scheduler's wait backend.
+     */
+    [[nodiscard]] time_point now() const { return backend_.now(); }
+
+    /**
+     * @brief Register a callback to be called every @p interval, starting one interval from now.
+     * @details A zero interval registers a dormant timer that only ticks when woken with
+     * wake_at(), once per call.
+     * @return id that can be passed to remove_timer().
+     * @throws std::invalid_argument if the interval is negative.
+     */
+    template <typename Callback>
+    timer_id add_timer(Callback &&callback, const time_type &interval,
+                       const timer_options &options = {}) {
+      using callback_type = std::decay_t<Callback>;
+      static_assert(details::is_periodic_callback_v<callback_type>,
+                    "dp::scheduler: callback must be callable as f() or f(dp::tick_info)");
+      check_interval(interval);
+      std::unique_lock<std::mutex> lock(mutex_);
+      const auto id = next_id_++;
+      auto node = std::make_unique<details::timer_impl<callback_type>>(
+          id, interval, options, std::forward<Callback>(callback));
+      return insert(lock, std::move(node));
+    }
+
+    /**
+     * @brief Register a timer whose callback of type @p Callback is constructed in place from
+     * @p args, directly in the timer's storage. The callback is never moved, so it does not need
+     * to be movable.
+     * @return id that can be passed to remove_timer().
+     * @throws std::invalid_argument if the interval is negative.
+     */
+    template <typename Callback, typename... Args>
+    timer_id emplace_timer(const time_type &interval, const timer_options &options,
+                           Args &&...args) {
+      static_assert(details::is_periodic_callback_v<Callback>,
+                    "dp::scheduler: callback must be callable as f() or f(dp::tick_info)");
+      check_interval(interval);
+      std::unique_lock<std::mutex> lock(mutex_);
+      const auto id = next_id_++;
+      auto node = std::make_unique<details::timer_impl<Callback>>(id, interval, options,
+                                                                  std::forward<Args>(args)...);
+      return insert(lock, std::move(node));
+    }
+
+    /**
+     * @brief Move the next tick of a timer to @p deadline.
+     * @details Replaces the timer's current deadline; periodic timers continue at their interval
+     * from there. May be called from the timer's own callback. This wakes the dispatcher only if
+     * it is sleeping past @p deadline.
+     * @return false if no timer with this id is registered.
+     */
+    bool wake_at(timer_id id, const time_point &deadline) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      const auto it = timers_.find(id);
+      if (it == timers_.end() || it->second->removed) return false;
+      auto &node = *it->second;
+      node.deadline = deadline;
+      // the dispatcher must not advance the deadline once the running callback returns
+      node.rescheduled = executing_ == id;
+      deadlines_.push({deadline, id});
+      lower_cached_deadline(deadline);
+      const auto rearm = sleeping_ && deadline < sleep_target_;
+      lock.unlock();
+      if (rearm) backend_.wake();
+      return true;
+    }
+
+    /**
+     * @brief Create a timer group with a combined CPU budget per period.
+     * @return id to set as timer_options::group when adding timers.
+     * @throws std::invalid_argument if the period is not positive or the budget is negative.
+     */
+    group_id add_group(const group_options &options) {
+      if (options.period <= std::chrono::nanoseconds::zero()) {
+        throw std::invalid_argument("dp::scheduler: group period must be positive");
+      }
+      if (options.cpu_budget < std::chrono::nanoseconds::zero()) {
+        throw std::invalid_argument("dp::scheduler: group CPU budget must not be negative");
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto id = next_group_id_++;
+      groups_.emplace(id, group_state{options, now(), {}});
+      return id;
+    }
+
+    /**
+     * @brief Usage of a timer group. Unknown groups report no usage.
+     */
+    [[nodiscard]] group_stats group_usage(group_id id) const {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto it = groups_.find(id);
+      return it == groups_.end() ? group_stats{} : it->second.stats;
+    }
+
+    /**
+     * @brief Unregister a timer.
+     * @details If the timer's callback is running on the dispatcher, this waits for it to finish
+     * (unless called from the callback itself), so captured state can be released afterwards.
+     * Removal never wakes a sleeping dispatcher; stale deadlines are discarded lazily.
+     * @return false if no timer with this id is registered.
+     */
+    bool remove_timer(timer_id id) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      const auto it = timers_.find(id);
+      if (it == timers_.end() || it->second->removed) return false;
+      if (executing_ == id) {
+        // the dispatcher releases the node once the callback returns
+        it->second->removed = true;
+        if (std::this_thread::get_id() != executing_thread_) {
+          idle_condition_.wait(lock, [&]() { return executing_ != id; });
+        }
+        return true;
+      }
+      timers_.erase(it);
+      return true;
+    }
+
+    /**
+     * @brief Replace the callback of a registered timer without disturbing its schedule.
+     * @details The new callable may be of a different type. If the current callback is running,
+     * the swap happens once it returns; the old callable is destroyed after the swap, never while
+     * a tick is still using it. The timer's deadline (and therefore its phase) is unchanged.
+     * @return false if no timer with this id is registered.
+     */
+    template <typename Callback> bool replace_callback(timer_id id, Callback &&callback) {
+      using callback_type = std::decay_t<Callback>;
+      static_assert(details::is_periodic_callback_v<callback_type>,
+                    "dp::scheduler: callback must be callable as f() or f(dp::tick_info)");
+      std::unique_ptr<details::timer_node> retired{};
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = timers_.find(id);
+        if (it == timers_.end() || it->second->removed) return false;
+        auto &current = it->second;
+        auto replacement = std::make_unique<details::timer_impl<callback_type>>(
+            id, current->interval(), current->options(), std::forward<Callback>(callback));
+        if (executing_ == id) {
+          // a previous pending replacement that never ran is simply dropped
+          retired = std::exchange(current->replacement, std::move(replacement));
+        } else {
+          replacement->deadline = current->deadline;
+          replacement->tick_count = current->tick_count;
+          retired = std::exchange(current, std::move(replacement));
+        }
+      }
+      return true;
+    }
+
+    /**
+     * @brief Number of registered timers.
+     */
+    [[nodiscard]] std::size_t size() const {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::size_t count = 0;
+      for (const auto &[id, node] : timers_) {
+        if (!node->removed) ++count;
+      }
+      return count;
+    }
+
+    /**
+     * @brief Run every timer that is due at @p now on the calling thread, for schedulers
+     * created with scheduler_options::polling.
+     * @details Meant to be called on every iteration of a busy polling loop. When nothing is due
+     * this only compares @p now against a cached earliest deadline: no lock, no system call and
+     * no atomic read-modify-write (the cache is read with a relaxed load). Due timers are
+     * dispatched in priority order as by the dispatcher thread, and timers that fall due while
+     * their callbacks run are left for the next call. Must not be called concurrently from
+     * several threads; use one scheduler per polling thread instead. Has no effect on schedulers
+     * that run their own dispatcher thread.
+     * @return the number of callbacks that were invoked.
+     */
+    std::size_t run_due(const time_point &now) {
+      if (now.time_since_epoch().count() < cached_deadline_.load(std::memory_order_relaxed)) {
+        return 0;
+      }
+      return run_due_locked(now);
+    }
+
+    /**
+     * @brief run_due() at the current time of the scheduler's clock.
+     */
+    std::size_t poll() { return run_due(now()); }
+
+    /**
+     * @brief Earliest deadline of any registered timer, or time_point::max() if there is none.
+     */
+    [[nodiscard]] time_point next_deadline() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      prune_stale();
+      return deadlines_.empty() ? time_point::max() : deadlines_.top().deadline;
+    }
+
+    /**
+     * @brief Snapshot of per-priority-class dispatch statistics.
+     */
+    [[nodiscard]] scheduler_stats stats() const {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return stats_;
+    }
+
+  private:
+    struct deadline_entry {
+      time_point deadline;
+      timer_id id;
+      bool operator>(const deadline_entry &other) const noexcept {
+        return deadline != other.deadline ? deadline > other.deadline : id > other.id;
+      }
+    };
+
+    struct ready_entry {
+      timer_id id;
+      time_point deadline;
+    };
+
+    struct group_state {
+      group_options options;
+      time_point period_start;
+      group_stats stats;
+
+      /// @brief Start a new budget period if the current one has ended.
+      void roll(const time_point &now) {
+        if (now - period_start < options.period) return;
+        period_start += options.period * ((now - period_start) / options.period);
+        stats.period_cpu_time = std::chrono::nanoseconds{0};
+      }
+
+      [[nodiscard]] bool over_budget() const noexcept {
+        return stats.period_cpu_time >= options.cpu_budget;
+      }
+    };
+
+    enum class dispatch_result { idle, skipped, invoked };
+
+    static constexpr time_type::rep max_ticks = time_point::max().time_since_epoch().count();
+
+    using deadline_queue = std::priority_queue<deadline_entry, std::vector<deadline_entry>,
+                                               std::greater<deadline_entry>>;
+
+    /// @brief A negative interval would never move the deadline forward, see dispatch_next().
+    static void check_interval(const time_type &interval) {
+      if (interval < time_type::zero()) {
+        throw std::invalid_argument("dp::scheduler: timer interval must not be negative");
+      }
+    }
+
+    /// @brief Schedule a new node one interval from now. Releases @p lock.
+    timer_id insert(std::unique_lock<std::mutex> &lock, std::unique_ptr<details::timer_node> node) {
+      const auto id = node->id();
+      if (node->interval() == time_type::zero()) {
+        // dormant until wake_at()
+        node->deadline = time_point::max();
+        timers_.emplace(id, std::move(node));
+        return id;
+      }
+      node->deadline = now() + node->interval();
+      deadlines_.push({node->deadline, id});
+      lower_cached_deadline(node->deadline);
+      // only wake the dispatcher if it is asleep and must re-arm for an earlier deadline
+      const auto rearm = sleeping_ && node->deadline < sleep_target_;
+      timers_.emplace(id, std::move(node));
+      lock.unlock();
+      if (rearm) backend_.wake();
+      return id;
+    }
+
+    /// @brief true if @p entry is the current deadline of a registered timer.
+    [[nodiscard]] bool is_live(const deadline_entry &entry) const {
+      const auto it = timers_.find(entry.id);
+      return it != timers_.end() && !it->second->removed && it->second->deadline == entry.deadline;
+    }
+
+    /// @brief Drop heap entries of removed or rescheduled timers until the top is live.
+    void prune_stale() {
+      while (!deadlines_.empty() && !is_live(deadlines_.top())) deadlines_.pop();
+    }
+
+    /// @brief Move every timer that is due at @p now into its ready queue.
+    void collect_due(const time_point &now) {
+      while (!deadlines_.empty() && deadlines_.top().deadline <= now) {
+        const auto entry = deadlines_.top();
+        deadlines_.pop();
+        // lazily drop entries of removed or rescheduled timers
+        if (!is_live(entry)) continue;
+        ready_[timers_.find(entry.id)->second->priority_index()].push_back(
+            {entry.id, entry.deadline});
+      }
+    }
+
+    /// @brief Index of the ready queue to dispatch from next, or priority_count if none.
+    [[nodiscard]] std::size_t next_ready_class(const time_point &now) const {
+      auto best = priority_count;
+      auto best_rank = std::numeric_limits<std::int64_t>::max();
+      for (std::size_t level = 0; level < priority_count; ++level) {
+        if (ready_[level].empty()) continue;
+        auto rank = static_cast<std::int64_t>(level);
+        if (options_.aging_threshold.count() > 0) {
+          const auto waited = now - ready_[level].front().deadline;
+          rank -= waited / options_.aging_threshold;
+          if (rank < 0) rank = 0;
+        }
+        // on equal (aged) rank, the timer that has waited longest goes first
+        const auto waited_longer
+            = best != priority_count
+              && ready_[level].front().deadline < ready_[best].front().deadline;
+        if (rank < best_rank || (rank == best_rank && waited_longer)) {
+          best = level;
+          best_rank = rank;
+        }
+      }
+      return best;
+    }
+
+    void run() {
+      if (options_.numa_node != no_numa_node) bind_current_thread_to_numa_node(options_.numa_node);
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (!stop_) {
+        const auto current = now();
+        collect_due(current);
+        if (dispatch_next(lock, current) != dispatch_result::idle) continue;
+
+        // tickless: sleep exactly until the earliest live deadline, or indefinitely when idle
+        prune_stale();
+        sleep_target_ = deadlines_.empty() ? time_point::max() : deadlines_.top().deadline;
+        sleeping_ = true;
+        backend_.arm(sleep_target_);
+        // wakeups are latched, so one sent after unlocking but before waiting is not lost
+        lock.unlock();
+        backend_.wait();
+        lock.lock();
+        sleeping_ = false;
+        ++stats_.wakeups;
+      }
+      backend_.cancel();
+    }
+
+    /// @brief Slow path of run_due(): dispatch everything due at @p now, then refresh the cache.
+    std::size_t run_due_locked(const time_point &now) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      collect_due(now);
+      std::size_t dispatched = 0;
+      auto result = dispatch_result::idle;
+      while ((result = dispatch_next(lock, now)) != dispatch_result::idle) {
+        if (result == dispatch_result::invoked) ++dispatched;
+      }
+      prune_stale();
+      cached_deadline_.store(
+          deadlines_.empty() ? max_ticks : deadlines_.top().deadline.time_since_epoch().count(),
+          std::memory_order_relaxed);
+      return dispatched;
+    }
+
+    /**
+     * @brief Dispatch the next ready timer, if any. Called with @p lock held.
+     */
+    dispatch_result dispatch_next(std::unique_lock<std::mutex> &lock, const time_point &now) {
+      const auto level = next_ready_class(now);
+      if (level == priority_count) return dispatch_result::idle;
+
+      const auto entry = ready_[level].front();
+      ready_[level].pop_front();
+      const auto found = timers_.find(entry.id);
+      if (found == timers_.end() || found->second->removed) return dispatch_result::skipped;
+      // moved by wake_at() after it became ready
+      if (found->second->deadline != entry.deadline) return dispatch_result::skipped;
+
+      // a group over its budget stretches its non-critical timers to the next period
+      auto group = groups_.end();
+      if (found->second->options().group != 0) {
+        group = groups_.find(found->second->options().group);
+        if (group != groups_.end()) {
+          group->second.roll(now);
+          if (group->second.over_budget()
+              && found->second->options().priority != priority::critical) {
+            auto &deferred = *found->second;
+            deferred.deadline = group->second.period_start + group->second.options.period;
+            deadlines_.push({deferred.deadline, deferred.id()});
+            ++group->second.stats.deferred;
+            return dispatch_result::skipped;
+          }
+        }
+      }
+
+      // keep the owner of a tracked timer alive while its callback runs
+      std::shared_ptr<const void> owner{};
+      if (found->second->tracks_lifetime()) {
+        owner = found->second->options().lifetime.lock();
+        if (!owner) {
+          // the owner is gone, lazily drop the timer
+          ++stats_.expired;
+          std::unique_ptr<details::timer_node> retired = std::move(found->second);
+          timers_.erase(found);
+          release(lock, retired);
+          return dispatch_result::skipped;
+        }
+      }
+      // the node stays alive while executing_ is set, but map iterators may be invalidated
+      auto &node = *found->second;
+
+      executing_ = entry.id;
+      executing_thread_ = std::this_thread::get_id();
+      lock.unlock();
+      const auto measure_cpu = group != groups_.end();
+      const auto cpu_start
+          = measure_cpu ? details::thread_cpu_time() : std::chrono::nanoseconds{};
+      const auto callback_start = backend_.now();
+      const tick_info info{entry.deadline, callback_start, node.tick_count++};
+      // suppress exceptions
+      try {
+        node.invoke(info);
+      } catch (...) {
+      }
+      const auto callback_end = backend_.now();
+      const auto cpu_time
+          = measure_cpu ? details::thread_cpu_time() - cpu_start : std::chrono::nanoseconds{};
+      // the owner's destructor may call back into the scheduler
+      owner.reset();
+      lock.lock();
+      executing_ = 0;
+      executing_thread_ = std::thread::id{};
+
+      if (measure_cpu) {
+        // groups are never erased, but add_group() may have rehashed the map meanwhile
+        auto &usage = groups_.find(node.options().group)->second.stats;
+        usage.cpu_time += cpu_time;
+        usage.period_cpu_time += cpu_time;
+        usage.wall_time += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            callback_end - callback_start);
+      }
+
+      auto &class_stats = stats_.classes[node.priority_index()];
+      const auto lateness
+          = std::chrono::duration_cast<std::chrono::nanoseconds>(callback_start - entry.deadline);
+      ++class_stats.dispatched;
+      class_stats.total_lateness += lateness;
+      if (lateness > class_stats.max_lateness) class_stats.max_lateness = lateness;
+
+      std::unique_ptr<details::timer_node> retired{};
+      const auto it = timers_.find(entry.id);
+      if (node.removed) {
+        retired = std::move(it->second);
+        timers_.erase(it);
+        idle_condition_.notify_all();
+        release(lock, retired);
+        return dispatch_result::invoked;
+      }
+
+      if (std::exchange(node.rescheduled, false)) {
+        // wake_at() already queued the next deadline
+      } else if (node.interval() == time_type::zero()) {
+        // dormant until the next wake_at()
+        node.deadline = time_point::max();
+      } else {
+        // schedule the next deadline, skipping any intervals that were missed entirely
+        const auto finished = backend_.now();
+        node.deadline += node.interval();
+        if (node.deadline <= finished) {
+          const auto missed = (finished - node.deadline) / node.interval() + 1;
+          node.deadline += node.interval() * missed;
+        }
+        deadlines_.push({node.deadline, node.id()});
+      }
+
+      if (node.replacement) {
+        // quiescent point: the old callable is no longer in use and can be swapped out
+        auto replacement = std::move(node.replacement);
+        replacement->deadline = node.deadline;
+        replacement->tick_count = node.tick_count;
+        retired = std::exchange(it->second, std::move(replacement));
+        release(lock, retired);
+      }
+      return dispatch_result::invoked;
+    }
+
+    /// @brief Let run_due() notice a new deadline that is earlier than the cached one.
+    void lower_cached_deadline(const time_point &deadline) noexcept {
+      if (!options_.polling) return;
+      const auto ticks = deadline.time_since_epoch().count();
+      if (ticks < cached_deadline_.load(std::memory_order_relaxed)) {
+        cached_deadline_.store(ticks, std::memory_order_relaxed);
+      }
+    }
+
+    /// @brief Destroy a retired node without holding the lock, its callable may call back in.
+    static void release(std::unique_lock<std::mutex> &lock,
+                        std::unique_ptr<details::timer_node> &retired) {
+      if (!retired) return;
+      lock.unlock();
+      retired.reset();
+      lock.lock();
+    }
+
+    scheduler_options options_;
+    WaitBackend backend_{};
+    mutable std::mutex mutex_{};
+    std::condition_variable idle_condition_{};
+    std::unordered_map<timer_id, std::unique_ptr<details::timer_node>> timers_{};
+    deadline_queue deadlines_{};
+    std::array<std::deque<ready_entry>, priority_count> ready_{};
+    scheduler_stats stats_{};
+    std::unordered_map<group_id, group_state> groups_{};
+    timer_id next_id_{1};
+    group_id next_group_id_{1};
+    timer_id executing_{0};
+    std::thread::id executing_thread_{};
+    time_point sleep_target_{time_point::max()};
+    bool sleeping_{false};
+    bool stop_{false};
+    /// @brief Earliest deadline in ticks for the run_due() fast path, polling schedulers only.
+    std::atomic<time_type::rep> cached_deadline_{max_ticks};
+    std::thread dispatcher_{};
+  };
+
+  using scheduler = basic_scheduler<>;
+}  // namespace dp
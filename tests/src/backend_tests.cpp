@@ -0,0 +1,246 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <periodic_function/backends.hpp>
+#include <periodic_function/periodic_function.hpp>
+#include <periodic_function/scheduler.hpp>
+#include <thread>
+
+#if defined(__linux__)
+#  include <pthread.h>
+#  include <signal.h>
+#  include <sys/resource.h>
+#endif
+
+using namespace std::chrono_literals;
+
+namespace {
+  /**
+   * @brief Moves time forward for backends that do not follow real time.
+   */
+  template <typename Backend> struct time_driver {};
+
+  template <> struct time_driver<dp::backends::simulated_backend> {
+    time_driver()
+        : thread([this]() {
+            while (!done) {
+              dp::simulated_clock::advance(1ms);
+              std::this_thread::sleep_for(50us);
+            }
+          }) {}
+    time_driver(const time_driver &) = delete;
+    time_driver &operator=(const time_driver &) = delete;
+    ~time_driver() {
+      done = true;
+      thread.join();
+    }
+
+    std::atomic_bool done{false};
+    std::thread thread;
+  };
+
+  // generous bound for real backends on loaded CI machines
+  constexpr auto tolerance = 100ms;
+
+  template <typename Backend> void check_backend_conformance() {
+    // the driver is declared first so it outlives the backend it may be waiting for
+    [[maybe_unused]] const time_driver<Backend> driver;
+    Backend backend;
+
+    // expires at the deadline, never before it
+    auto deadline = backend.now() + 20ms;
+    backend.arm(deadline);
+    CHECK(backend.wait() == dp::wait_status::expired);
+    CHECK_GE(backend.now(), deadline);
+    CHECK_LT(backend.now() - deadline, tolerance);
+
+    // a deadline in the past expires right away
+    deadline = backend.now() - 1ms;
+    backend.arm(deadline);
+    CHECK(backend.wait() == dp::wait_status::expired);
+    CHECK_LT(backend.now() - deadline, tolerance);
+
+    // re-arming replaces the previous deadline
+    backend.arm(backend.now() + 1h);
+    deadline = backend.now() + 10ms;
+    backend.arm(deadline);
+    CHECK(backend.wait() == dp::wait_status::expired);
+    CHECK_LT(backend.now() - deadline, tolerance);
+
+    // wake() from another thread interrupts a long wait
+    auto start = backend.now();
+    backend.arm(start + 1h);
+    std::thread waker([&backend]() {
+      std::this_thread::sleep_for(20ms);
+      backend.wake();
+    });
+    CHECK(backend.wait() == dp::wait_status::woken);
+    waker.join();
+    CHECK_LT(backend.now() - start, 1h);
+
+    // a wake() before wait() is not lost
+    backend.wake();
+    backend.arm(backend.now() + 1h);
+    CHECK(backend.wait() == dp::wait_status::woken);
+
+    // after cancel() only wake() ends the wait
+    start = backend.now();
+    backend.arm(start + 10ms);
+    backend.cancel();
+    std::thread late_waker([&backend]() {
+      std::this_thread::sleep_for(50ms);
+      backend.wake();
+    });
+    CHECK(backend.wait() == dp::wait_status::woken);
+    late_waker.join();
+    CHECK_GE(backend.now() - start, 40ms);
+  }
+
+  template <typename Backend> void check_timer_on_backend() {
+    [[maybe_unused]] const time_driver<Backend> driver;
+    std::atomic<int> calls{0};
+    dp::periodic_function<std::function<void()>, dp::policies::schedule_next_missed_interval_policy,
+                          dp::policies::ignore_errors_policy, Backend>
+        func([&calls]() { ++calls; }, 20ms);
+
+    // stop and early ticks are delivered through wake()
+    func.start();
+    func.trigger_now();
+    std::this_thread::sleep_for(10ms);
+    CHECK_GE(calls, 1);
+    func.stop();
+    const auto stopped_calls = calls.load();
+    std::this_thread::sleep_for(50ms);
+    CHECK_EQ(calls, stopped_calls);
+    CHECK_FALSE(func.is_running());
+  }
+}  // namespace
+
+TEST_CASE("condition_variable backend conformance") {
+  check_backend_conformance<dp::backends::condition_variable_backend>();
+  check_timer_on_backend<dp::backends::condition_variable_backend>();
+}
+
+TEST_CASE("spin backend conformance") {
+  check_backend_conformance<dp::backends::spin_backend>();
+  check_timer_on_backend<dp::backends::spin_backend>();
+}
+
+#if defined(__linux__)
+TEST_CASE("clock_nanosleep backend conformance") {
+  check_backend_conformance<dp::backends::clock_nanosleep_backend>();
+  check_timer_on_backend<dp::backends::clock_nanosleep_backend>();
+}
+
+TEST_CASE("clock_nanosleep backend sleeps through to the deadline") {
+  dp::backends::clock_nanosleep_backend backend;
+  rusage before{};
+  getrusage(RUSAGE_THREAD, &before);
+  backend.arm(backend.now() + 200ms);
+  CHECK(backend.wait() == dp::wait_status::expired);
+  rusage after{};
+  getrusage(RUSAGE_THREAD, &after);
+  // one sleep, not one wakeup per millisecond
+  CHECK_LE(after.ru_nvcsw - before.ru_nvcsw, 5);
+
+  // many wakes racing with the start of each sleep are never lost
+  std::atomic_bool done{false};
+  std::thread waker([&]() {
+    while (!done) {
+      backend.wake();
+      std::this_thread::yield();
+    }
+  });
+  for (int i = 0; i < 1'000; ++i) {
+    backend.arm(backend.now() + 1h);
+    CHECK(backend.wait() == dp::wait_status::woken);
+  }
+  done = true;
+  waker.join();
+}
+
+TEST_CASE("clock_nanosleep backend wakes threads that block real-time signals") {
+  dp::backends::clock_nanosleep_backend backend;
+  std::atomic_bool sleeping{false};
+  auto status = dp::wait_status::expired;
+  auto slept = std::chrono::steady_clock::duration{};
+
+  std::thread sleeper([&]() {
+    // as if spawned by an application that blocks real-time signals in all of its threads
+    sigset_t signals{};
+    sigemptyset(&signals);
+    sigaddset(&signals, dp::backends::clock_nanosleep_backend::wake_signal());
+    ::pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    const auto start = backend.now();
+    backend.arm(start + 2s);
+    sleeping = true;
+    status = backend.wait();
+    slept = backend.now() - start;
+  });
+  while (!sleeping) std::this_thread::yield();
+  std::this_thread::sleep_for(10ms);
+  backend.wake();
+  sleeper.join();
+
+  CHECK(status == dp::wait_status::woken);
+  CHECK_LT(slept, 1s);
+}
+
+TEST_CASE("timerfd backend conformance") {
+  check_backend_conformance<dp::backends::timerfd_backend>();
+  check_timer_on_backend<dp::backends::timerfd_backend>();
+}
+
+TEST_CASE("hybrid backend spins for the threshold before the deadline") {
+  using hybrid = dp::backends::hybrid_backend<>;
+  hybrid backend;
+  const auto cpu_time_of_wait = [&backend](std::chrono::nanoseconds threshold) {
+    hybrid::set_spin_threshold(threshold);
+    const auto start = dp::details::thread_cpu_time();
+    backend.arm(backend.now() + 50ms);
+    CHECK(backend.wait() == dp::wait_status::expired);
+    return dp::details::thread_cpu_time() - start;
+  };
+
+  CHECK_LT(cpu_time_of_wait(0ns), 20ms);
+  CHECK_GT(cpu_time_of_wait(50ms), 20ms);
+  hybrid::set_spin_threshold(0ns);
+}
+#endif
+
+TEST_CASE("hybrid backend conformance") {
+  using hybrid = dp::backends::hybrid_backend<>;
+  check_backend_conformance<hybrid>();
+  check_timer_on_backend<hybrid>();
+
+  // deadlines within the threshold are spun for, wakes still end the spin
+  hybrid::set_spin_threshold(5ms);
+  check_backend_conformance<hybrid>();
+  check_timer_on_backend<hybrid>();
+  hybrid::set_spin_threshold(0ns);
+
+#if defined(__linux__)
+  check_backend_conformance<dp::backends::hybrid_backend<dp::backends::timerfd_backend>>();
+#endif
+}
+
+TEST_CASE("simulated backend conformance") {
+  check_backend_conformance<dp::backends::simulated_backend>();
+  check_timer_on_backend<dp::backends::simulated_backend>();
+}
+
+TEST_CASE("Timers on the simulated backend tick exactly") {
+  dp::simulated_clock::reset();
+  std::atomic<int> calls{0};
+  dp::periodic_function<std::function<void()>, dp::policies::schedule_next_missed_interval_policy,
+                        dp::policies::ignore_errors_policy, dp::backends::simulated_backend>
+      func([&calls]() { ++calls; }, 10ms);
+
+  func.start();
+  dp::simulated_clock::advance(55ms);
+  CHECK_EQ(calls, 5);
+  dp::simulated_clock::advance(5ms);
+  CHECK_EQ(calls, 6);
+  func.stop();
+}
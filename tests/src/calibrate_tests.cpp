@@ -0,0 +1,74 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <periodic_function/calibrate.hpp>
+#include <sstream>
+#include <string>
+
+TEST_CASE("Calibrate wakeup lateness of available backends") {
+  dp::calibration_options options{};
+  options.samples = 20;
+  options.interval = std::chrono::microseconds{500};
+
+  const auto result = dp::calibrate(options);
+
+  // condition_variable and spin are available everywhere
+  const auto *cv = result.find(dp::wait_backend::condition_variable);
+  const auto *spin = result.find(dp::wait_backend::spin);
+  REQUIRE(cv != nullptr);
+  REQUIRE(spin != nullptr);
+  CHECK(cv->available);
+  CHECK(spin->available);
+
+  for (const auto &entry : result.backends) {
+    if (!entry.available) continue;
+    CHECK_EQ(entry.samples, options.samples);
+    CHECK_LE(entry.min, entry.p50);
+    CHECK_LE(entry.p50, entry.p99);
+    CHECK_LE(entry.p99, entry.max);
+  }
+
+  const auto *recommended = result.find(result.recommended_backend);
+  REQUIRE(recommended != nullptr);
+  CHECK(recommended->available);
+  CHECK_NE(result.recommended_backend, dp::wait_backend::spin);
+  CHECK_EQ(result.recommended_spin_threshold, recommended->p99);
+  CHECK_EQ(result.recommended_spin_threshold,
+           result.spin_threshold(result.recommended_backend));
+
+  // the report has a line per backend and names the recommendation
+  std::ostringstream report;
+  report << result;
+  const auto text = report.str();
+  for (const auto &entry : result.backends) {
+    CHECK_NE(text.find(std::string("  ") + dp::to_string(entry.backend) + ": "),
+             std::string::npos);
+  }
+  CHECK_NE(text.find(std::string("recommended: ") + dp::to_string(result.recommended_backend)),
+           std::string::npos);
+}
+
+TEST_CASE("Calibration configures the hybrid backend") {
+  using namespace std::chrono_literals;
+  using hybrid = dp::backends::hybrid_backend<dp::backends::condition_variable_backend>;
+  dp::calibration_options options{};
+  options.samples = 20;
+  options.interval = std::chrono::microseconds{500};
+
+  const auto result = dp::calibrate(options);
+  hybrid::set_spin_threshold(result.spin_threshold(hybrid::sleep_backend::kind));
+  const auto *measured = result.find(dp::wait_backend::condition_variable);
+  REQUIRE(measured != nullptr);
+  CHECK_EQ(hybrid::spin_threshold(), std::max(measured->p99, std::chrono::nanoseconds{0}));
+
+  // backends that were not measured get no threshold
+  CHECK_EQ(result.spin_threshold(dp::wait_backend::hybrid), 0ns);
+
+  hybrid backend;
+  const auto deadline = backend.now() + 5ms;
+  backend.arm(deadline);
+  CHECK(backend.wait() == dp::wait_status::expired);
+  CHECK_GE(backend.now(), deadline);
+  hybrid::set_spin_threshold(0ns);
+}
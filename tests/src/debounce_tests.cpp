@@ -0,0 +1,82 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <periodic_function/debounce.hpp>
+#include <thread>
+#include <vector>
+
+#include "tick_harness.hpp"
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Debouncer coalesces a burst into one call") {
+  harness::run([](auto backend) {
+    using backend_type = typename decltype(backend)::type;
+    harness::scheduler<decltype(backend)> scheduler;
+    std::atomic<int> calls{0};
+    dp::basic_debouncer<backend_type> debounce(scheduler, [&calls]() { ++calls; }, 50ms);
+
+    // a burst of 100ms with events every millisecond
+    for (int i = 0; i < 100; ++i) {
+      debounce.notify();
+      harness::elapse(1ms);
+    }
+    CHECK_EQ(calls, 0);
+    harness::elapse(80ms);
+    CHECK_EQ(calls, 1);
+
+    // a second burst is handled on its own
+    debounce.notify();
+    harness::elapse(80ms);
+    CHECK_EQ(calls, 2);
+  });
+}
+
+TEST_CASE("Debouncer does not wake the scheduler without events") {
+  harness::run([](auto backend) {
+    using backend_type = typename decltype(backend)::type;
+    harness::scheduler<decltype(backend)> scheduler;
+    dp::basic_debouncer<backend_type> debounce(scheduler, []() {}, 10ms);
+    harness::elapse(100ms);
+    CHECK_EQ(scheduler.stats().wakeups, 0U);
+  });
+}
+
+TEST_CASE("Throttler calls at most once per interval") {
+  harness::run([](auto backend) {
+    using backend_type = typename decltype(backend)::type;
+    harness::scheduler<decltype(backend)> scheduler;
+    std::atomic<int> calls{0};
+    dp::basic_throttler<backend_type> throttle(scheduler, [&calls]() { ++calls; }, 50ms);
+
+    // the first event is handled right away
+    throttle.notify();
+    harness::elapse(10ms);
+    CHECK_EQ(calls, 1);
+
+    // notify from several threads for 225ms. The producers are not tied to the simulated
+    // clock, so this thread also notifies once per millisecond
+    std::atomic<bool> done{false};
+    std::vector<std::thread> producers;
+    for (int i = 0; i < 3; ++i) {
+      producers.emplace_back([&throttle, &done]() {
+        while (!done) throttle.notify();
+      });
+    }
+    for (int i = 0; i < 225; ++i) {
+      throttle.notify();
+      harness::elapse(1ms);
+    }
+    done = true;
+    for (auto &producer : producers) producer.join();
+    harness::elapse(120ms);
+
+    // one call per 50ms interval, plus the trailing call for the last events
+    CHECK_GE(calls, 5);
+    CHECK_LE(calls, 7);
+    const auto settled = calls.load();
+    harness::elapse(100ms);
+    CHECK_EQ(calls, settled);
+  });
+}
@@ -0,0 +1,112 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <periodic_function/latency_histogram.hpp>
+#include <periodic_function/periodic_function.hpp>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Latency histogram buckets keep the relative error bounded") {
+  using histogram = dp::latency_histogram;
+  // exact below the first power of two range
+  for (std::uint64_t value = 0; value < histogram::sub_bucket_count; ++value) {
+    CHECK_EQ(histogram::bucket_index(value), value);
+    CHECK_EQ(histogram::lowest_equivalent_value(histogram::bucket_index(value)), value);
+  }
+  const std::uint64_t samples[]
+      = {32, 33, 63, 64, 1000, 123'456, 1'000'000'007, histogram::max_trackable_value};
+  for (const auto value : samples) {
+    const auto index = histogram::bucket_index(value);
+    CHECK_LT(index, histogram::bucket_count);
+    CHECK_LE(histogram::lowest_equivalent_value(index), value);
+    CHECK_GE(histogram::highest_equivalent_value(index), value);
+    const auto width = histogram::highest_equivalent_value(index)
+                       - histogram::lowest_equivalent_value(index) + 1;
+    CHECK_LE(width * histogram::sub_bucket_count, value);
+  }
+  // buckets are contiguous
+  for (std::size_t index = 1; index < histogram::bucket_count; ++index) {
+    CHECK_EQ(histogram::lowest_equivalent_value(index),
+             histogram::highest_equivalent_value(index - 1) + 1);
+  }
+  // out of range values saturate
+  CHECK_EQ(histogram::bucket_index(histogram::max_trackable_value + 1),
+           histogram::bucket_count - 1);
+}
+
+TEST_CASE("Latency histogram percentiles") {
+  dp::latency_histogram histogram;
+  CHECK_EQ(histogram.percentile(50.0), 0ns);
+  for (int i = 1; i <= 1000; ++i) histogram.record(std::chrono::microseconds{i});
+  histogram.record(-5ns);
+  CHECK_EQ(histogram.count(), 1001);
+  CHECK_EQ(histogram.min(), 0ns);
+  const auto median = std::chrono::duration<double, std::micro>(histogram.percentile(50.0));
+  CHECK_EQ(median.count(), doctest::Approx(500.0).epsilon(0.04));
+  const auto p99 = std::chrono::duration<double, std::micro>(histogram.percentile(99.0));
+  CHECK_EQ(p99.count(), doctest::Approx(990.0).epsilon(0.04));
+  const auto max = std::chrono::duration<double, std::micro>(histogram.max());
+  CHECK_EQ(max.count(), doctest::Approx(1000.0).epsilon(0.04));
+  CHECK_EQ(histogram.percentile(100.0), histogram.max());
+}
+
+TEST_CASE("Latency histograms merge and round trip through serialization") {
+  dp::latency_histogram first;
+  dp::latency_histogram second;
+  // record concurrently into the same histogram
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 4; ++t) {
+    writers.emplace_back([&first]() {
+      for (int i = 0; i < 10'000; ++i) first.record(std::chrono::nanoseconds{i});
+    });
+  }
+  for (auto &writer : writers) writer.join();
+  CHECK_EQ(first.count(), 40'000);
+  second.record(1s);
+  second.merge(first);
+  CHECK_EQ(second.count(), 40'001);
+
+  const auto bytes = second.serialize();
+  const auto restored = dp::latency_histogram::deserialize(bytes);
+  CHECK_EQ(restored.count(), second.count());
+  for (std::size_t index = 0; index < dp::latency_histogram::bucket_count; ++index) {
+    CHECK_EQ(restored.bucket(index), second.bucket(index));
+  }
+  // only non-empty buckets are written
+  CHECK_LT(bytes.size(), 1024);
+
+  auto corrupt = bytes;
+  corrupt[0] = std::byte{'X'};
+  CHECK_THROWS_AS(dp::latency_histogram::deserialize(corrupt), std::invalid_argument);
+  const std::vector<std::byte> truncated(bytes.begin(), bytes.begin() + 9);
+  CHECK_THROWS_AS(dp::latency_histogram::deserialize(truncated), std::invalid_argument);
+  using coarse = dp::basic_latency_histogram<3, 30>;
+  CHECK_THROWS_AS(coarse::deserialize(bytes), std::invalid_argument);
+}
+
+TEST_CASE("Timers record execution time and lateness into attached stats") {
+  dp::timer_stats stats;
+  dp::periodic_function func([]() { std::this_thread::sleep_for(2ms); }, 10ms);
+  func.attach_stats(&stats);
+  func.start();
+  std::this_thread::sleep_for(105ms);
+  func.stop();
+  CHECK_GE(stats.execution.count(), 5);
+  CHECK_EQ(stats.lateness.count(), stats.execution.count());
+  CHECK_GE(stats.execution.min(), 1ms);
+
+  // detached timers record nothing
+  const auto recorded = stats.execution.count();
+  func.attach_stats(nullptr);
+  func.start();
+  std::this_thread::sleep_for(35ms);
+  func.stop();
+  CHECK_EQ(stats.execution.count(), recorded);
+}
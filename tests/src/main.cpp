@@ -1,3 +1,23 @@
-#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#define DOCTEST_CONFIG_IMPLEMENT
 
 #include <doctest/doctest.h>
+
+#include <cstring>
+
+#include "tick_harness.hpp"
+
+int main(int argc, char **argv) {
+  // --realtime runs the timing tests on real time instead of the simulated clock
+  int kept = 0;
+  for (int i = 0; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--realtime") == 0) {
+      harness::realtime() = true;
+    } else {
+      argv[kept++] = argv[i];
+    }
+  }
+
+  doctest::Context context;
+  context.applyCommandLine(kept, argv);
+  return context.run();
+}
@@ -0,0 +1,114 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <periodic_function/mapped_time_series.hpp>
+#include <periodic_function/periodic_function.hpp>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+  struct temp_file {
+    std::filesystem::path path;
+    explicit temp_file(const char *name)
+        : path(std::filesystem::temp_directory_path() / name) {
+      std::filesystem::remove(path);
+    }
+    ~temp_file() { std::filesystem::remove(path); }
+  };
+
+  struct sample {
+    std::int32_t id;
+    double value;
+  };
+}  // namespace
+
+TEST_CASE("Mapped time series wraps its write cursor") {
+  temp_file file("dp_time_series_wrap.bin");
+  dp::mapped_time_series<sample> series(file.path.string(), 4);
+
+  CHECK_EQ(series.size(), 0U);
+  for (std::int32_t i = 0; i < 6; ++i) {
+    series.append(std::chrono::system_clock::time_point{std::chrono::seconds{i}},
+                  sample{i, i * 0.5});
+  }
+
+  CHECK_EQ(series.write_cursor(), 6U);
+  CHECK_EQ(series.size(), 4U);
+  // oldest retained record is the third one appended
+  for (std::size_t i = 0; i < series.size(); ++i) {
+    const auto expected = static_cast<std::int32_t>(i + 2);
+    CHECK_EQ(series.value(i).id, expected);
+    CHECK_EQ(series.timestamp(i).time_since_epoch(), std::chrono::seconds{expected});
+  }
+}
+
+TEST_CASE("Mapped time series resumes from an existing file") {
+  temp_file file("dp_time_series_resume.bin");
+  {
+    dp::mapped_time_series<std::int64_t> series(file.path.string(), 8);
+    series.append(1);
+    series.append(2);
+    series.append(3);
+  }
+
+  dp::mapped_time_series<std::int64_t> reopened(file.path.string(), 8);
+  CHECK_EQ(reopened.write_cursor(), 3U);
+  CHECK_EQ(reopened.value(2), 3);
+
+  // a different layout is rejected and leaves the file untouched
+  const auto size = std::filesystem::file_size(file.path);
+  CHECK_THROWS_AS(dp::mapped_time_series<std::int64_t>(file.path.string(), 16),
+                  std::invalid_argument);
+  CHECK_THROWS_AS(dp::mapped_time_series<std::int32_t>(file.path.string(), 8),
+                  std::invalid_argument);
+  CHECK_THROWS_AS(dp::mapped_time_series<std::int64_t>(file.path.string(), 0),
+                  std::invalid_argument);
+  CHECK_EQ(std::filesystem::file_size(file.path), size);
+  CHECK_EQ(reopened.value(0), 1);
+
+  // unless discarding it is asked for explicitly
+  dp::mapped_time_series<std::int64_t> resized(file.path.string(), 16,
+                                               dp::series_open_mode::reinitialize);
+  CHECK_EQ(resized.write_cursor(), 0U);
+  CHECK_EQ(resized.capacity(), 16U);
+}
+
+TEST_CASE("Mapped time series refuses files that are not a series") {
+  temp_file file("dp_time_series_foreign.bin");
+  {
+    std::ofstream foreign(file.path, std::ios::binary);
+    foreign << "not a time series";
+  }
+  CHECK_THROWS_AS(dp::mapped_time_series<std::int64_t>(file.path.string(), 8),
+                  std::invalid_argument);
+  CHECK_EQ(std::filesystem::file_size(file.path), 17U);
+
+  // a zero capacity is rejected before the file is created
+  temp_file missing("dp_time_series_missing.bin");
+  CHECK_THROWS_AS(dp::mapped_time_series<std::int64_t>(missing.path.string(), 0),
+                  std::invalid_argument);
+  CHECK_FALSE(std::filesystem::exists(missing.path));
+}
+
+TEST_CASE("Record periodic function results to a mapped time series") {
+  temp_file file("dp_time_series_record.bin");
+  dp::mapped_time_series<int, std::chrono::steady_clock> series(file.path.string(), 64);
+
+  std::atomic<int> tick{0};
+  const auto interval = std::chrono::milliseconds{20};
+  dp::periodic_function func(dp::record_to(series, [&tick]() { return ++tick; }), interval);
+  func.start();
+  std::this_thread::sleep_for(interval * 5 + interval / 2);
+  func.stop();
+
+  REQUIRE_EQ(series.size(), static_cast<std::size_t>(tick.load()));
+  CHECK_GE(series.size(), 4U);
+  for (std::size_t i = 1; i < series.size(); ++i) {
+    CHECK_EQ(series.value(i), series.value(i - 1) + 1);
+    CHECK_GT(series.timestamp(i), series.timestamp(i - 1));
+  }
+}
@@ -0,0 +1,82 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <periodic_function/numa.hpp>
+#include <periodic_function/periodic_function.hpp>
+#include <periodic_function/scheduler.hpp>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#  include <sched.h>
+#endif
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Parse sysfs cpu lists") {
+  using list = std::vector<unsigned>;
+  CHECK((dp::details::parse_cpu_list("0") == list{0}));
+  CHECK((dp::details::parse_cpu_list("0-3\n") == list{0, 1, 2, 3}));
+  CHECK((dp::details::parse_cpu_list("0-1,8,10-11") == list{0, 1, 8, 10, 11}));
+  CHECK(dp::details::parse_cpu_list("").empty());
+  CHECK(dp::details::parse_cpu_list("3-1").empty());
+  CHECK(dp::details::parse_cpu_list("a,b").empty());
+}
+
+TEST_CASE("NUMA arena allocations are aligned and bounded") {
+  dp::numa_arena arena(4096, 0);
+  CHECK_GE(arena.capacity(), 4096U);
+  auto *first = arena.allocate(3, 1);
+  auto *second = arena.allocate(16, 64);
+  REQUIRE(first != nullptr);
+  REQUIRE(second != nullptr);
+  CHECK_EQ(reinterpret_cast<std::uintptr_t>(second) % 64, 0U);
+  CHECK(arena.allocate(arena.capacity()) == nullptr);
+
+  std::vector<std::uint64_t, dp::numa_allocator<std::uint64_t>> samples{
+      dp::numa_allocator<std::uint64_t>(arena)};
+  samples.resize(64, 7);
+  CHECK_EQ(samples.back(), 7U);
+  CHECK_THROWS_AS(samples.resize(arena.capacity()), std::bad_alloc);
+}
+
+TEST_CASE("Timers run on the CPUs of their NUMA node") {
+  const auto cpus = dp::numa_node_cpus(0);
+  if (cpus.empty()) return;  // no NUMA topology information on this host
+  CHECK_GE(dp::numa_node_count(), 1);
+
+  std::atomic<int> calls{0};
+  std::atomic<bool> on_node{true};
+  const auto check_cpu = [&]() {
+    ++calls;
+#if defined(__linux__)
+    const auto cpu = sched_getcpu();
+    if (cpu >= 0 && std::find(cpus.begin(), cpus.end(), static_cast<unsigned>(cpu)) == cpus.end()) {
+      on_node = false;
+    }
+#endif
+  };
+
+  dp::periodic_function<std::function<void()>> func(check_cpu, 10ms);
+  func.set_numa_node(0);
+  CHECK_EQ(func.numa_node(), 0);
+  func.start();
+  std::this_thread::sleep_for(35ms);
+  func.stop();
+  CHECK_GE(calls, 2);
+
+  dp::scheduler_options options;
+  options.numa_node = 0;
+  {
+    dp::scheduler scheduler(options);
+    scheduler.add_timer(check_cpu, 10ms);
+    std::this_thread::sleep_for(35ms);
+  }
+  CHECK_GE(calls, 4);
+  CHECK(on_node);
+}
@@ -7,8 +7,14 @@
 #include <functional>
 #include <iostream>
 #include <periodic_function/periodic_function.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "tick_harness.hpp"
+
 struct callback_counter {
   std::atomic<int> count{0};
   void on_timeout() {
@@ -17,58 +23,61 @@ struct callback_counter {
   }
 };
 
-TEST_CASE("Acceptable function timing") {
-  struct test_callback {
-    std::chrono::high_resolution_clock::time_point last_call{};
-    double interval_sum{0.0};
-    std::atomic<int> count{};
-    bool first_call = true;
-    void on_timeout() {
-      if (first_call) {
-        first_call = false;
-        last_call = std::chrono::high_resolution_clock::now();
-        return;
-      }
-
-      ++count;
-
-      // check elapsed time against the interval time
-      const auto now = std::chrono::high_resolution_clock::now();
-      const auto elapsed_time
-          = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_call);
-      interval_sum += static_cast<double>(elapsed_time.count());
-
-      std::cout << "Elapsed time: " << elapsed_time.count() << std::endl;
-      last_call = now;
+namespace {
+  std::atomic<int> free_function_calls{0};
+  void free_function() { ++free_function_calls; }
+
+  struct wake_counting_backend : dp::backends::condition_variable_backend {
+    static inline std::atomic<int> wakes{0};
+    void wake() {
+      ++wakes;
+      condition_variable_backend::wake();
     }
   };
+}  // namespace
+
+// callable shapes accepted as callbacks
+static_assert(dp::details::is_periodic_callback_v<void (*)()>);
+static_assert(dp::details::is_periodic_callback_v<int (*)()>);
+static_assert(dp::details::is_periodic_callback_v<void (*)(const dp::tick_info &)>);
+static_assert(dp::details::is_periodic_callback_v<std::function<bool()>>);
+static_assert(dp::details::is_periodic_callback_v<std::function<void(dp::tick_info)>>);
+static_assert(!dp::details::is_periodic_callback_v<void (*)(int)>);
+static_assert(!dp::details::is_periodic_callback_v<int>);
+#if defined(__cpp_concepts) && __cpp_concepts >= 201907L
+static_assert(dp::periodic_callback<decltype(free_function)>);
+static_assert(!dp::periodic_callback<void (*)(int, int)>);
+// the concept constrains the timer itself
+template <typename Callback> concept timer_callback = requires {
+  typename dp::periodic_function<Callback>;
+};
+static_assert(timer_callback<std::function<void()>>);
+static_assert(!timer_callback<void (*)(int)>);
+#endif
 
-  std::vector<std::chrono::milliseconds> intervals
-      = {std::chrono::milliseconds{100}, std::chrono::milliseconds{300},
-         std::chrono::milliseconds{500}, std::chrono::milliseconds{1000}};
-
-  for (const auto &interval : intervals) {
-    test_callback callback{};
-
-    dp::periodic_function func(std::bind(&test_callback::on_timeout, &callback), interval);
-    func.start();
-
-    const auto total_cycles = 25;
-    const auto wake_time
-        = std::chrono::high_resolution_clock::now() + (interval * total_cycles) + (interval / 2);
-    std::this_thread::sleep_until(wake_time);
-
-    func.stop();
-
-    // subtract 1 because we can't calculate an interval on the first cycle.
-    CHECK_EQ(callback.count, total_cycles - 1);
-
-    // calculate the average time between cycles
-    const auto average_interval = callback.interval_sum / static_cast<double>(callback.count);
-
-    // Might be better to check each interval instead of the average
-    CHECK_LE(std::abs(average_interval - static_cast<double>(interval.count())), 1);
-  }
+TEST_CASE("Acceptable function timing") {
+  harness::run([](auto backend) {
+    using timer = harness::timer<decltype(backend)>;
+    const std::vector<std::chrono::milliseconds> intervals = {
+        std::chrono::milliseconds{100}, std::chrono::milliseconds{300},
+        std::chrono::milliseconds{500}, std::chrono::milliseconds{1000}};
+
+    for (const auto &interval : intervals) {
+      constexpr auto total_cycles = 25;
+      harness::tick_recorder ticks(total_cycles + 1);
+      timer func(std::ref(ticks), interval);
+      func.start();
+      harness::elapse(interval * total_cycles + interval / 2);
+      func.stop();
+
+      REQUIRE_EQ(ticks.size(), static_cast<std::size_t>(total_cycles));
+      CHECK_EQ(ticks.dropped(), 0U);
+      const auto jitter = ticks.jitter(interval);
+      CHECK_LE(jitter.period_error.mean, harness::limit(std::chrono::milliseconds{1}));
+      CHECK_LE(jitter.period_error.percentile(99.0), harness::limit(std::chrono::milliseconds{5}));
+      CHECK_LE(jitter.lateness.percentile(99.0), harness::limit(std::chrono::milliseconds{5}));
+    }
+  });
 }
 
 TEST_CASE("Callable destruction") {
@@ -94,23 +103,20 @@ TEST_CASE("Callable destruction") {
 }
 
 TEST_CASE("Repeatedly start callable") {
-  const std::chrono::milliseconds interval{200};
-
-  callback_counter counter;
-
-  dp::periodic_function func(std::bind(&callback_counter::on_timeout, &counter), interval);
-
-  const auto call_count = 5;
-  for (auto i = 0; i < call_count; ++i) {
-    func.start();
-  }
-  const auto wake_time
-      = std::chrono::high_resolution_clock::now() + (call_count * interval) + (interval / 2);
-  std::this_thread::sleep_until(wake_time);
-  func.stop();
-  std::cout << "Callback count: " << counter.count << '\n';
+  harness::run([](auto backend) {
+    const std::chrono::milliseconds interval{200};
+    harness::tick_recorder ticks(16);
+    harness::timer<decltype(backend)> func(std::ref(ticks), interval);
+
+    const auto call_count = 5;
+    for (auto i = 0; i < call_count; ++i) {
+      func.start();
+    }
+    harness::elapse(call_count * interval + interval / 2);
+    func.stop();
 
-  CHECK_EQ(counter.count, call_count);
+    CHECK_EQ(ticks.size(), static_cast<std::size_t>(call_count));
+  });
 }
 
 TEST_CASE("Callback takes as long or longer than interval") {
@@ -195,49 +201,665 @@ TEST_CASE("Immediately invoke on callback interval miss") {
 }
 
 TEST_CASE("Suppress exceptions in callback") {
-  const auto interval = std::chrono::milliseconds{300};
+  harness::run([](auto backend) {
+    const auto interval = std::chrono::milliseconds{300};
+    harness::tick_recorder ticks(16);
+    harness::timer<decltype(backend)> function(
+        [&ticks](const dp::tick_info &info) {
+          ticks.record(info);
+          throw std::runtime_error("Error in callback.");
+        },
+        interval);
+
+    const auto call_count = 10;
+    CHECK_NOTHROW({
+      function.start();
+      harness::elapse(call_count * interval + interval / 2);
+      function.stop();
+    });
+
+    CHECK_EQ(ticks.size(), static_cast<std::size_t>(call_count));
+  });
+}
+
+TEST_CASE("Check move ctor and assignment operator") {
+  harness::run([](auto backend) {
+    using timer = harness::timer<decltype(backend)>;
+    const auto interval = std::chrono::milliseconds{500};
+    const auto call_count = 4;
+    harness::tick_recorder ticks(16);
+    timer func1(std::ref(ticks), interval);
+
+    func1.start();
+    timer func2 = std::move(func1);
+
+    CHECK_EQ(func2.is_running(), true);
+
+    timer func3(std::move(func2));
+
+    CHECK_EQ(func3.is_running(), true);
+
+    harness::elapse(interval * call_count + (interval / 2));
+    func3.stop();
 
-  callback_counter counter;
-  dp::periodic_function function(
+    CHECK_EQ(ticks.size(), static_cast<std::size_t>(call_count));
+  });
+}
+
+TEST_CASE("Moving a running timer keeps its error policy state") {
+  harness::run([](auto backend) {
+    const auto interval = std::chrono::milliseconds{50};
+    std::atomic<int> calls{0};
+
+    using timer = harness::timer<decltype(backend), std::function<void()>,
+                                 dp::policies::schedule_next_missed_interval_policy,
+                                 dp::policies::record_errors_policy>;
+    const auto failing = [&calls]() {
+      ++calls;
+      throw std::runtime_error("failure");
+    };
+    timer func1(failing, interval);
+    func1.start();
+    harness::elapse(interval * 2 + interval / 2);
+
+    timer func2(std::move(func1));
+    CHECK(func2.is_running());
+    harness::elapse(interval * 2);
+
+    // the target's own timer thread is stopped before it is overwritten
+    timer func3([]() {}, interval);
+    func3.start();
+    func3 = std::move(func2);
+    CHECK(func3.is_running());
+    harness::elapse(interval * 2);
+    func3.stop();
+
+    CHECK_GE(calls, 4);
+    CHECK_EQ(func3.error_policy().error_count(), static_cast<std::uint64_t>(calls.load()));
+  });
+}
+
+TEST_CASE("Compile time disabled periodic function") {
+  using callback_type = std::function<void()>;
+  static_assert(std::is_same_v<dp::periodic_function_if<false, callback_type>,
+                               dp::disabled_periodic_function<callback_type>>);
+  static_assert(std::is_same_v<dp::periodic_function_if<true, callback_type>,
+                               dp::periodic_function<callback_type>>);
+
+  // copyable neither when enabled nor when disabled
+  using disabled_type = dp::disabled_periodic_function<callback_type>;
+  static_assert(!std::is_copy_constructible_v<dp::periodic_function<callback_type>>);
+  static_assert(!std::is_copy_constructible_v<disabled_type>);
+  static_assert(!std::is_constructible_v<disabled_type, disabled_type &>);
+  static_assert(!std::is_copy_assignable_v<disabled_type>);
+  static_assert(std::is_nothrow_move_constructible_v<disabled_type>);
+  static_assert(std::is_nothrow_move_assignable_v<disabled_type>);
+
+  harness::run([](auto backend) {
+    using backend_type = typename decltype(backend)::type;
+    using missed_interval_policy = dp::policies::schedule_next_missed_interval_policy;
+    using error_policy = dp::policies::ignore_errors_policy;
+    const auto interval = std::chrono::milliseconds{50};
+    std::atomic<int> calls{0};
+
+    auto disabled = dp::make_periodic_function<false, missed_interval_policy, error_policy,
+                                               backend_type>([&]() { ++calls; }, interval);
+    static_assert(std::is_empty_v<decltype(disabled)>);
+    disabled.start();
+    CHECK_FALSE(disabled.is_running());
+    harness::elapse(interval * 2);
+    disabled.stop();
+    CHECK_EQ(calls, 0);
+
+    auto enabled = dp::make_periodic_function<true, missed_interval_policy, error_policy,
+                                              backend_type>([&]() { ++calls; }, interval);
+    enabled.start();
+    CHECK(enabled.is_running());
+    harness::elapse(interval * 2 + interval / 2);
+    enabled.stop();
+    CHECK_EQ(calls, 2);
+  });
+}
+
+namespace {
+  /**
+   * @brief Uses every member of the timer interface, so it only compiles if the enabled and the
+   * disabled timer both provide all of them.
+   */
+  template <typename Timer> void use_timer_interface(Timer &timer) {
+    timer.set_trigger_spacing(std::chrono::milliseconds{1});
+    timer.set_numa_node(dp::no_numa_node);
+    timer.attach_stats(nullptr);
+    timer.replace_callback([]() {});
+    timer.start();
+    timer.trigger_now();
+    timer.trigger_now(dp::trigger_phase::reset);
+    [[maybe_unused]] const bool running = timer.is_running();
+    [[maybe_unused]] const auto errors = timer.error_policy().error_count();
+    [[maybe_unused]] const auto &interval_policy = timer.interval_policy();
+    [[maybe_unused]] const auto interval = timer.interval();
+    [[maybe_unused]] const auto spacing = timer.trigger_spacing();
+    [[maybe_unused]] const auto node = timer.numa_node();
+    timer.stop();
+  }
+}  // namespace
+
+TEST_CASE("Disabled periodic function provides the full timer interface") {
+  using callback_type = std::function<void()>;
+  using missed_interval_policy = dp::policies::schedule_next_missed_interval_policy;
+  using error_policy = dp::policies::record_errors_policy;
+  using enabled_type
+      = dp::periodic_function_if<true, callback_type, missed_interval_policy, error_policy>;
+  using disabled_type
+      = dp::periodic_function_if<false, callback_type, missed_interval_policy, error_policy>;
+  static_assert(std::is_empty_v<disabled_type>);
+
+  enabled_type enabled([]() {}, std::chrono::hours{1});
+  disabled_type disabled([]() {}, std::chrono::hours{1});
+  use_timer_interface(enabled);
+  use_timer_interface(disabled);
+  CHECK_FALSE(disabled.is_running());
+  CHECK_EQ(disabled.error_policy().error_count(), 0U);
+}
+
+TEST_CASE("Record exceptions thrown by the callback") {
+  harness::run([](auto backend) {
+    const auto interval = std::chrono::milliseconds{50};
+    std::atomic<int> calls{0};
+
+    using timer = harness::timer<decltype(backend), std::function<void()>,
+                                 dp::policies::schedule_next_missed_interval_policy,
+                                 dp::policies::record_errors_policy>;
+    timer func(
+        [&]() {
+          // fail on every call but the fourth
+          if (++calls != 4) throw std::runtime_error("failure " + std::to_string(calls.load()));
+        },
+        interval);
+    func.start();
+    harness::elapse(interval * 5 + interval / 2);
+    CHECK(func.is_running());
+    func.stop();
+
+    CHECK_EQ(calls, 5);
+    CHECK_EQ(func.error_policy().error_count(), 4U);
+    CHECK_EQ(func.error_policy().consecutive_errors(), 1U);
+    const auto error = func.error_policy().last_error();
+    REQUIRE(error != nullptr);
+    CHECK_THROWS_AS(std::rethrow_exception(error), std::runtime_error);
+  });
+}
+
+TEST_CASE("Stop the timer after consecutive failures") {
+  harness::run([](auto backend) {
+    const auto interval = std::chrono::milliseconds{20};
+    std::atomic<int> calls{0};
+
+    using timer = harness::timer<decltype(backend), std::function<void()>,
+                                 dp::policies::schedule_next_missed_interval_policy,
+                                 dp::policies::stop_on_consecutive_errors_policy<3>>;
+    timer func(
+        [&]() {
+          ++calls;
+          throw std::runtime_error("dependency down");
+        },
+        interval);
+    func.start();
+    harness::elapse(interval * 10);
+
+    CHECK_FALSE(func.is_running());
+    CHECK_EQ(calls, 3);
+    CHECK_EQ(func.error_policy().consecutive_errors(), 3U);
+
+    // the timer can be restarted, and counts failures from zero again
+    func.start();
+    CHECK(func.is_running());
+    CHECK_EQ(func.error_policy().consecutive_errors(), 0U);
+    harness::elapse(interval * 2 + interval / 2);
+    CHECK(func.is_running());
+    CHECK_EQ(calls, 5);
+    harness::elapse(interval);
+    CHECK_FALSE(func.is_running());
+    CHECK_EQ(calls, 6);
+    func.stop();
+  });
+}
+
+TEST_CASE("Rethrow callback exceptions from stop") {
+  harness::run([](auto backend) {
+    const auto interval = std::chrono::milliseconds{20};
+    using timer = harness::timer<decltype(backend), std::function<void()>,
+                                 dp::policies::schedule_next_missed_interval_policy,
+                                 dp::policies::rethrow_on_stop_policy>;
+    timer func([]() { throw std::runtime_error("failed"); }, interval);
+    func.start();
+    harness::elapse(interval * 3);
+
+    CHECK_THROWS_AS(func.stop(), std::runtime_error);
+    // the error is only reported once
+    CHECK_NOTHROW(func.stop());
+    CHECK_EQ(func.error_policy().last_error(), nullptr);
+  });
+}
+
+TEST_CASE("Circuit breaker skips ticks while a dependency is down") {
+  const auto interval = std::chrono::milliseconds{20};
+  std::atomic<int> calls{0};
+  std::atomic<bool> dependency_up{false};
+
+  using breaker = dp::policies::circuit_breaker_policy<3, 200>;
+  using per_func = dp::periodic_function<std::function<bool()>,
+                                         dp::policies::schedule_next_missed_interval_policy,
+                                         breaker>;
+  // failure is reported through the return code
+  per_func func(
       [&]() {
-        counter.on_timeout();
-        throw std::runtime_error("Error in callback.");
+        ++calls;
+        return dependency_up.load();
       },
       interval);
+  func.start();
+
+  // three failures open the circuit, then ticks are skipped for the cooldown
+  std::this_thread::sleep_for(interval * 3 + interval / 2);
+  CHECK_EQ(func.error_policy().state(), dp::policies::circuit_state::open);
+  std::this_thread::sleep_for(interval * 5);
+  CHECK_EQ(calls, 3);
+  CHECK_GE(func.error_policy().skipped_ticks(), 4U);
+
+  // the probe after the cooldown succeeds and closes the circuit
+  dependency_up = true;
+  std::this_thread::sleep_for(std::chrono::milliseconds{200});
+  func.stop();
+  CHECK_EQ(func.error_policy().state(), dp::policies::circuit_state::closed);
+  CHECK_EQ(func.error_policy().times_opened(), 1U);
+  CHECK_GT(calls, 4);
+  CHECK_EQ(func.error_policy().error_count(), 3U);
+}
 
-  const auto call_count = 10;
-  CHECK_NOTHROW({
-    function.start();
-    const auto wake_time
-        = std::chrono::high_resolution_clock::now() + (call_count * interval) + (interval / 2);
-    std::this_thread::sleep_until(wake_time);
-    function.stop();
+TEST_CASE("Circuit breaker re-opens when the probe fails") {
+  const auto interval = std::chrono::milliseconds{10};
+  std::atomic<int> calls{0};
+
+  using breaker = dp::policies::circuit_breaker_policy<2, 100>;
+  using per_func = dp::periodic_function<std::function<void()>,
+                                         dp::policies::schedule_next_missed_interval_policy,
+                                         breaker>;
+  per_func func(
+      [&]() {
+        ++calls;
+        throw std::runtime_error("still down");
+      },
+      interval);
+  func.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds{290});
+  func.stop();
+
+  // two failures to open, then one failed probe after each cooldown
+  CHECK_EQ(func.error_policy().times_opened(), 3U);
+  CHECK_EQ(calls, 4);
+  CHECK(func.error_policy().last_error() != nullptr);
+}
+
+TEST_CASE("Replace the callback without stopping the timer") {
+  harness::run([](auto backend) {
+    const auto interval = std::chrono::milliseconds{50};
+    std::atomic<int> first{0};
+    std::atomic<int> second{0};
+
+    harness::timer<decltype(backend), std::function<void()>> func([&]() { ++first; }, interval);
+    func.start();
+    harness::elapse(interval * 3 + interval / 2);
+    func.replace_callback([&]() { ++second; });
+    CHECK(func.is_running());
+    harness::elapse(interval * 3);
+    func.stop();
+
+    // the timer kept its phase across the swap
+    CHECK_EQ(first, 3);
+    CHECK_EQ(second, 3);
+
+    // replacing a stopped timer takes effect immediately
+    func.replace_callback([&]() { first = -1; });
+    func.start();
+    harness::elapse(interval + interval / 2);
+    func.stop();
+    CHECK_EQ(first, -1);
   });
+}
 
-  CHECK_EQ(counter.count, call_count);
+TEST_CASE("Function pointer callbacks") {
+  harness::run([](auto backend) {
+    const auto interval = std::chrono::milliseconds{50};
+    free_function_calls = 0;
+    harness::timer<decltype(backend), void (*)()> func(&free_function, interval);
+    func.start();
+    harness::elapse(interval * 3 + interval / 2);
+    func.stop();
+    CHECK_EQ(free_function_calls, 3);
+  });
 }
 
-TEST_CASE("Check move ctor and assignment operator") {
-  const auto interval = std::chrono::milliseconds{500};
-  const auto call_count = 4;
-  callback_counter counter;
-  dp::periodic_function func1(
-      [&, function_id = 1]() {
-        counter.on_timeout();
-        std::cout << "function id: " << function_id << "\n";
+TEST_CASE("Callbacks receive tick info") {
+  harness::run([](auto backend) {
+    const auto interval = std::chrono::milliseconds{50};
+    harness::tick_recorder ticks(8);
+
+    harness::timer<decltype(backend)> func(std::ref(ticks), interval);
+    func.start();
+    harness::elapse(interval * 4 + interval / 2);
+    func.stop();
+
+    REQUIRE_EQ(ticks.size(), 4U);
+    for (std::size_t i = 0; i < ticks.size(); ++i) {
+      CHECK_EQ(ticks[i].tick_count, i);
+      CHECK_GE(ticks[i].start_time, ticks[i].scheduled_time);
+      if (i > 0) CHECK_EQ(ticks[i].scheduled_time - ticks[i - 1].scheduled_time, interval);
+    }
+    CHECK_LE(ticks.jitter(interval).lateness.max, harness::limit(std::chrono::milliseconds{10}));
+  });
+}
+
+TEST_CASE("Bind member functions without std::bind") {
+  struct sensor {
+    std::atomic<int> polls{0};
+    std::uint64_t last_tick{0};
+    void poll() { ++polls; }
+    void poll_with_info(const dp::tick_info &info) { last_tick = info.tick_count; }
+  };
+
+  harness::run([](auto backend) {
+    using tag = decltype(backend);
+    const auto interval = std::chrono::milliseconds{50};
+
+    sensor compile_time{};
+    using bound_type = decltype(dp::periodic_function(
+        dp::bind_member<&sensor::poll>(compile_time), interval));
+    static_assert(sizeof(dp::bind_member<&sensor::poll>(compile_time)) == sizeof(sensor *));
+    harness::timer_like<tag, bound_type> bound(dp::bind_member<&sensor::poll>(compile_time),
+                                               interval);
+
+    sensor run_time{};
+    using member_type = decltype(dp::periodic_function(&sensor::poll, &run_time, interval));
+    harness::timer_like<tag, member_type> member(&sensor::poll, &run_time, interval);
+
+    sensor with_info{};
+    harness::timer_like<tag, decltype(dp::periodic_function(
+                                 dp::bind_member<&sensor::poll_with_info>(with_info), interval))>
+        info(dp::bind_member<&sensor::poll_with_info>(with_info), interval);
+
+    bound.start();
+    member.start();
+    info.start();
+    harness::elapse(interval * 3 + interval / 2);
+    bound.stop();
+    member.stop();
+    info.stop();
+
+    CHECK_EQ(compile_time.polls, 3);
+    CHECK_EQ(run_time.polls, 3);
+    CHECK_EQ(with_info.last_tick, 2U);
+  });
+}
+
+TEST_CASE("Construct from lvalues, function references and in place") {
+  struct functor {
+    std::atomic<int> *counter;
+    int increment;
+    functor(std::atomic<int> *target, int step) : counter(target), increment(step) {}
+    void operator()() const { *counter += increment; }
+  };
+
+  harness::run([](auto backend) {
+    using tag = decltype(backend);
+    const auto interval = std::chrono::milliseconds{50};
+    std::atomic<int> calls{0};
+
+    // lvalue callable is copied, no std::function wrapping or explicit move needed
+    const auto lambda = [&calls]() { ++calls; };
+    using lambda_type = std::decay_t<decltype(lambda)>;
+    using from_lvalue_type = decltype(dp::periodic_function(lambda, interval));
+    static_assert(std::is_same_v<from_lvalue_type, dp::periodic_function<lambda_type>>);
+    harness::timer_like<tag, from_lvalue_type> from_lvalue(lambda, interval);
+
+    // function references decay to function pointers
+    free_function_calls = 0;
+    using from_reference_type = decltype(dp::periodic_function(free_function, interval));
+    static_assert(std::is_same_v<from_reference_type, dp::periodic_function<void (*)()>>);
+    harness::timer_like<tag, from_reference_type> from_reference(free_function, interval);
+
+    std::atomic<int> in_place_calls{0};
+    using in_place_type = decltype(dp::periodic_function(std::in_place_type<functor>, interval,
+                                                         &in_place_calls, 10));
+    static_assert(std::is_same_v<in_place_type, dp::periodic_function<functor>>);
+    harness::timer_like<tag, in_place_type> in_place(std::in_place_type<functor>, interval,
+                                                     &in_place_calls, 10);
+
+    from_lvalue.start();
+    from_reference.start();
+    in_place.start();
+    harness::elapse(interval * 3 + interval / 2);
+    from_lvalue.stop();
+    from_reference.stop();
+    in_place.stop();
+
+    CHECK_EQ(calls, 3);
+    CHECK_EQ(free_function_calls, 3);
+    CHECK_EQ(in_place_calls, 30);
+  });
+}
+
+TEST_CASE("Construct non-movable callbacks in place") {
+  struct pinned {
+    std::atomic<int> *counter;
+    std::array<char, 4096> buffer{};
+    explicit pinned(std::atomic<int> *target) : counter(target) {}
+    pinned(const pinned &) = delete;
+    pinned(pinned &&) = delete;
+    pinned &operator=(const pinned &) = delete;
+    pinned &operator=(pinned &&) = delete;
+    ~pinned() = default;
+    void operator()() { ++*counter; }
+  };
+
+  harness::run([](auto backend) {
+    const auto interval = std::chrono::milliseconds{50};
+    std::atomic<int> calls{0};
+    harness::timer<decltype(backend), pinned> func(std::in_place, interval, &calls);
+    func.start();
+    harness::elapse(interval * 2 + interval / 2);
+    func.stop();
+    CHECK_EQ(calls, 2);
+  });
+}
+
+TEST_CASE("Concurrent start, stop and is_running") {
+  harness::run([](auto backend) {
+    const auto interval = std::chrono::milliseconds{1};
+    std::atomic<int> calls{0};
+    harness::timer<decltype(backend), std::function<void()>> func([&calls]() { ++calls; },
+                                                                  interval);
+
+    std::atomic<bool> go{false};
+    std::vector<std::thread> controllers;
+    for (int i = 0; i < 4; ++i) {
+      controllers.emplace_back([&func, &go, i]() {
+        while (!go) std::this_thread::yield();
+        for (int round = 0; round < 200; ++round) {
+          if ((round + i) % 2 == 0) {
+            func.start();
+          } else {
+            func.stop();
+          }
+          [[maybe_unused]] const auto running = func.is_running();
+        }
+      });
+    }
+    go = true;
+    for (auto &controller : controllers) controller.join();
+
+    // the timer ends up in a consistent state either way
+    func.start();
+    CHECK(func.is_running());
+    harness::elapse(interval * 20);
+    func.stop();
+    CHECK_FALSE(func.is_running());
+    CHECK_GT(calls, 0);
+  });
+}
+
+TEST_CASE("Adaptive interval holds the target duty cycle") {
+  using namespace std::chrono_literals;
+  using policy_type = dp::policies::adaptive_interval_policy<std::ratio<1, 4>>;
+
+  // a 10ms callback on a 20ms interval needs a 40ms interval for a 25% duty cycle
+  policy_type policy;
+  std::chrono::nanoseconds interval = 20ms;
+  for (int tick = 0; tick < 100; ++tick) {
+    [[maybe_unused]] const auto next = policy.schedule(std::chrono::nanoseconds{10ms}, interval);
+  }
+  CHECK_EQ(policy.scale(), doctest::Approx(2.0).epsilon(0.01));
+  const std::chrono::duration<double, std::milli> adapted = policy.current_interval(interval);
+  CHECK_EQ(adapted.count(), doctest::Approx(40.0).epsilon(0.01));
+
+  // overruns are bounded by the maximum scale
+  policy_type overrun;
+  for (int tick = 0; tick < 100; ++tick) {
+    [[maybe_unused]] const auto next = overrun.schedule(std::chrono::nanoseconds{1s}, interval);
+  }
+  CHECK_EQ(overrun.scale(), doctest::Approx(policy_type::max_scale));
+
+  // cheap callbacks poll faster, down to the minimum scale
+  std::atomic<int> calls{0};
+  using callback_type = std::function<void()>;
+  dp::periodic_function<callback_type, policy_type> poller([&calls]() { ++calls; }, 20ms);
+  poller.start();
+  std::this_thread::sleep_for(300ms);
+  poller.stop();
+  CHECK_EQ(poller.interval_policy().scale(), doctest::Approx(policy_type::min_scale));
+  CHECK_GT(calls, 30);
+
+  // sub-millisecond callbacks are measured, not rounded down to free: a 500us callback on a
+  // 2ms interval already runs at the target duty cycle
+  dp::periodic_function<callback_type, policy_type> worker(
+      []() {
+        const auto until = std::chrono::steady_clock::now() + 500us;
+        while (std::chrono::steady_clock::now() < until) {
+        }
       },
-      interval);
+      2ms);
+  worker.start();
+  std::this_thread::sleep_for(300ms);
+  worker.stop();
+  CHECK_GT(worker.interval_policy().scale(), 0.5);
+}
 
-  func1.start();
-  dp::periodic_function func2 = std::move(func1);
+TEST_CASE("Trigger an early tick and preserve the phase") {
+  harness::run([](auto backend) {
+    const auto interval = std::chrono::milliseconds{200};
+    harness::tick_recorder ticks(8);
+    harness::timer<decltype(backend)> func(std::ref(ticks), interval);
 
-  CHECK_EQ(func2.is_running(), true);
+    func.start();
+    const auto started = harness::now();
+    harness::elapse(std::chrono::milliseconds{50});
+    func.trigger_now();
+    harness::elapse(std::chrono::milliseconds{20});
+    CHECK_EQ(ticks.size(), 1U);
+    // the regular tick still happens one interval after starting
+    harness::elapse(std::chrono::milliseconds{180});
+    func.stop();
+    REQUIRE_EQ(ticks.size(), 2U);
+    CHECK_LE(ticks[0].start_time - started,
+             std::chrono::milliseconds{50} + harness::limit(std::chrono::milliseconds{50}));
+    CHECK_LE(ticks[1].scheduled_time - started, interval);
+    CHECK_GE(ticks[1].scheduled_time - started, interval - harness::limit(interval / 20));
+  });
+}
 
-  dp::periodic_function func3(std::move(func2));
+TEST_CASE("Trigger before start has no effect") {
+  harness::run([](auto backend) {
+    const auto interval = std::chrono::milliseconds{200};
+    harness::tick_recorder ticks(8);
+    harness::timer<decltype(backend)> func(std::ref(ticks), interval);
 
-  CHECK_EQ(func3.is_running(), true);
+    func.trigger_now();
+    func.start();
+    harness::elapse(std::chrono::milliseconds{100});
+    CHECK_EQ(ticks.size(), 0U);
+    harness::elapse(std::chrono::milliseconds{100} + harness::limit(interval / 4));
+    func.stop();
+    CHECK_EQ(ticks.size(), 1U);
+  });
+
+  // nor is a wakeup latched for the next start
+  wake_counting_backend::wakes = 0;
+  dp::periodic_function<std::function<void()>, dp::policies::schedule_next_missed_interval_policy,
+                        dp::policies::ignore_errors_policy, wake_counting_backend>
+      func([]() {}, std::chrono::hours{1});
+  func.trigger_now();
+  CHECK_EQ(wake_counting_backend::wakes, 0);
+  func.start();
+  func.stop();
+  func.trigger_now();
+  CHECK_EQ(wake_counting_backend::wakes, 1);
+}
+
+TEST_CASE("Trigger an early tick and reset the phase") {
+  harness::run([](auto backend) {
+    const auto interval = std::chrono::milliseconds{200};
+    harness::tick_recorder ticks(8);
+    harness::timer<decltype(backend)> func(std::ref(ticks), interval);
+
+    func.start();
+    harness::elapse(std::chrono::milliseconds{100});
+    func.trigger_now(dp::trigger_phase::reset);
+    // the regular tick moved to one interval after the early tick
+    harness::elapse(std::chrono::milliseconds{150});
+    CHECK_EQ(ticks.size(), 1U);
+    harness::elapse(std::chrono::milliseconds{100});
+    func.stop();
+    REQUIRE_EQ(ticks.size(), 2U);
+    CHECK_EQ(ticks[1].scheduled_time - ticks[0].start_time, interval);
+  });
+}
 
-  std::this_thread::sleep_for(interval * call_count + (interval / 2));
+TEST_CASE("Early ticks keep a minimum spacing") {
+  harness::run([](auto backend) {
+    const auto spacing = std::chrono::milliseconds{100};
+    harness::tick_recorder ticks(8);
+    harness::timer<decltype(backend)> func(std::ref(ticks), std::chrono::milliseconds{200});
+    func.set_trigger_spacing(spacing);
 
-  CHECK_EQ(counter.count, call_count);
+    func.start();
+    // a burst of triggers only produces spaced out ticks
+    for (int i = 0; i < 150; ++i) {
+      func.trigger_now();
+      harness::elapse(std::chrono::milliseconds{1});
+    }
+    func.stop();
+    REQUIRE_EQ(ticks.size(), 2U);
+    CHECK_GE(ticks[1].start_time - ticks[0].start_time, spacing);
+    CHECK_LE(ticks[1].start_time - ticks[0].start_time,
+             spacing + harness::limit(std::chrono::milliseconds{20}));
+  });
+}
+
+TEST_CASE("The first early tick is not held back by the trigger spacing") {
+  harness::run([](auto backend) {
+    // the simulated clock starts at the epoch, where a spacing measured from a default
+    // constructed time point would still be running
+    if (!harness::realtime()) dp::simulated_clock::reset();
+    harness::tick_recorder ticks(8);
+    harness::timer<decltype(backend)> func(std::ref(ticks), std::chrono::milliseconds{200});
+    func.set_trigger_spacing(std::chrono::milliseconds{100});
+
+    func.start();
+    harness::elapse(std::chrono::milliseconds{10});
+    func.trigger_now();
+    harness::elapse(std::chrono::milliseconds{10});
+    func.stop();
+    // held back, it would only have run after 100ms
+    CHECK_EQ(ticks.size(), 1U);
+  });
 }
@@ -0,0 +1,397 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <periodic_function/scheduler.hpp>
+#include <thread>
+#include <vector>
+
+#include "tick_harness.hpp"
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Scheduler calls timers at their interval") {
+  harness::run([](auto backend) {
+    harness::scheduler<decltype(backend)> scheduler;
+    std::atomic<int> fast{0};
+    std::atomic<int> slow{0};
+
+    scheduler.add_timer([&]() { ++fast; }, 50ms);
+    scheduler.add_timer([&]() { ++slow; }, 100ms);
+    CHECK_EQ(scheduler.size(), 2U);
+
+    harness::elapse(525ms);
+    CHECK_EQ(fast, 10);
+    CHECK_EQ(slow, 5);
+  });
+}
+
+TEST_CASE("Scheduler dispatches critical timers ahead of a low priority burst") {
+  // runs on real time: the lateness under test comes from the running time of the callbacks,
+  // which the simulated clock does not advance by
+  dp::scheduler scheduler;
+  std::mutex order_mutex;
+  std::vector<dp::priority> order;
+  const auto record = [&](dp::priority level) {
+    std::lock_guard<std::mutex> lock(order_mutex);
+    order.push_back(level);
+  };
+  const auto recorded = [&]() {
+    std::lock_guard<std::mutex> lock(order_mutex);
+    return order.size();
+  };
+
+  dp::timer_options low{};
+  low.priority = dp::priority::low;
+  dp::timer_options critical{};
+  critical.priority = dp::priority::critical;
+
+  // the housekeeping burst is registered first, so it falls due slightly earlier
+  std::vector<dp::timer_id> ids;
+  for (auto i = 0; i < 5; ++i) {
+    ids.push_back(scheduler.add_timer(
+        [&]() {
+          record(dp::priority::low);
+          std::this_thread::sleep_for(20ms);
+        },
+        200ms, low));
+  }
+  ids.push_back(
+      scheduler.add_timer([&]() { record(dp::priority::critical); }, 200ms, critical));
+
+  // wait for the burst to be dispatched once, however slow the machine is
+  const auto give_up = std::chrono::steady_clock::now() + 5s;
+  while (recorded() < 6 && std::chrono::steady_clock::now() < give_up) {
+    std::this_thread::sleep_for(10ms);
+  }
+  for (const auto id : ids) scheduler.remove_timer(id);
+  {
+    std::lock_guard<std::mutex> lock(order_mutex);
+    REQUIRE(order.size() >= 6U);
+    // at most the low priority callback that was already running delays the critical one
+    const auto critical_position = std::find(order.begin(), order.end(), dp::priority::critical);
+    CHECK_LE(std::distance(order.begin(), critical_position), 1);
+  }
+
+  const auto stats = scheduler.stats();
+  CHECK_GE(stats[dp::priority::critical].dispatched, 1U);
+  CHECK_GE(stats[dp::priority::low].dispatched, 5U);
+  CHECK_LT(stats[dp::priority::critical].max_lateness, stats[dp::priority::low].max_lateness);
+}
+
+TEST_CASE("Scheduler aging prevents starvation of low priority timers") {
+  // runs on real time: the overload comes from the running time of the critical callbacks. The
+  // checks do not depend on how fast the machine is, there is always an overdue critical timer
+  const auto run = [](const dp::scheduler_options &options) {
+    dp::scheduler scheduler(options);
+    std::atomic<int> low_calls{0};
+    dp::timer_options critical{};
+    critical.priority = dp::priority::critical;
+    dp::timer_options low{};
+    low.priority = dp::priority::low;
+
+    // between them there is always an overdue critical timer, so in strict priority mode
+    // nothing else gets to run
+    for (auto i = 0; i < 3; ++i) {
+      scheduler.add_timer([]() { std::this_thread::sleep_for(5ms); }, 1ms, critical);
+    }
+    scheduler.add_timer([&]() { ++low_calls; }, 10ms, low);
+    std::this_thread::sleep_for(200ms);
+    return low_calls.load();
+  };
+
+  CHECK_EQ(run(dp::scheduler_options{}), 0);
+
+  dp::scheduler_options aging{};
+  aging.aging_threshold = 10ms;
+  CHECK_GT(run(aging), 0);
+}
+
+TEST_CASE("Scheduler remove timer waits for a running callback") {
+  harness::run([](auto backend) {
+    harness::scheduler<decltype(backend)> scheduler;
+    std::atomic<bool> in_callback{false};
+    std::atomic<int> calls{0};
+
+    const auto id = scheduler.add_timer(
+        [&]() {
+          in_callback = true;
+          std::this_thread::sleep_for(50ms);
+          ++calls;
+          in_callback = false;
+        },
+        20ms);
+
+    // elapse() returns once the tick is done, remove the timer while it is running
+    std::thread ticker([]() { harness::elapse(20ms); });
+    while (!in_callback) std::this_thread::yield();
+    CHECK(scheduler.remove_timer(id));
+    CHECK_FALSE(in_callback);
+    CHECK_EQ(calls, 1);
+    CHECK_FALSE(scheduler.remove_timer(id));
+    CHECK_EQ(scheduler.size(), 0U);
+    ticker.join();
+
+    harness::elapse(100ms);
+    CHECK_EQ(calls, 1);
+  });
+}
+
+TEST_CASE("Scheduler does not wake up while idle") {
+  harness::run([](auto backend) {
+    using scheduler_type = harness::scheduler<decltype(backend)>;
+    scheduler_type scheduler;
+    harness::elapse(200ms);
+    CHECK_EQ(scheduler.stats().wakeups, 0U);
+    CHECK_EQ(scheduler.next_deadline(), scheduler_type::time_point::max());
+
+    // removed timers never cause a wakeup once their stale deadline is pruned
+    const auto id = scheduler.add_timer([]() {}, 10min);
+    CHECK_LT(scheduler.next_deadline(), scheduler_type::time_point::max());
+    CHECK(scheduler.remove_timer(id));
+    CHECK_EQ(scheduler.next_deadline(), scheduler_type::time_point::max());
+  });
+}
+
+TEST_CASE("Scheduler wakes up once per deadline") {
+  harness::run([](auto backend) {
+    harness::scheduler<decltype(backend)> scheduler;
+    std::atomic<int> calls{0};
+    scheduler.add_timer([&]() { ++calls; }, 50ms);
+    scheduler.add_timer([&]() { ++calls; }, 100ms);
+    // a later deadline does not re-arm the sleeping dispatcher
+    scheduler.add_timer([&]() { ++calls; }, 10min);
+
+    harness::elapse(525ms);
+    const auto wakeups = scheduler.stats().wakeups;
+    CHECK_EQ(calls, 15);
+    // every 100ms deadline coincides with (or on real time lies within microseconds of) a 50ms
+    // one, so there are between 10 and 15 distinct wakeup instants, plus the re-arm when the
+    // first timer was added
+    CHECK_GE(wakeups, 10U);
+    CHECK_LE(wakeups, 16U);
+  });
+}
+
+TEST_CASE("Scheduler replaces a timer callback between ticks") {
+  harness::run([](auto backend) {
+    harness::scheduler<decltype(backend)> scheduler;
+    std::atomic<int> first{0};
+    std::atomic<int> second{0};
+    std::atomic<bool> in_callback{false};
+    std::atomic<bool> replaced{false};
+
+    const auto id = scheduler.add_timer(
+        [&]() {
+          in_callback = true;
+          while (!replaced) std::this_thread::yield();
+          ++first;
+        },
+        50ms);
+
+    // replace while the old callback is running, with a callable of a different type
+    std::thread ticker([]() { harness::elapse(50ms); });
+    while (!in_callback) std::this_thread::yield();
+    CHECK(scheduler.replace_callback(id, [&second]() { ++second; }));
+    replaced = true;
+    ticker.join();
+    harness::elapse(125ms);
+
+    CHECK_EQ(first, 1);
+    CHECK_EQ(second, 2);
+    CHECK_FALSE(scheduler.replace_callback(id + 1, []() {}));
+  });
+}
+
+TEST_CASE("Scheduler passes tick info to callbacks that accept it") {
+  harness::run([](auto backend) {
+    harness::scheduler<decltype(backend)> scheduler;
+    harness::tick_recorder ticks(8);
+
+    scheduler.add_timer(std::ref(ticks), 40ms);
+    harness::elapse(140ms);
+
+    REQUIRE_EQ(ticks.size(), 3U);
+    for (std::size_t i = 0; i < ticks.size(); ++i) {
+      CHECK_EQ(ticks[i].tick_count, i);
+      CHECK_GE(ticks[i].start_time, ticks[i].scheduled_time);
+    }
+    CHECK_EQ(ticks[2].scheduled_time - ticks[1].scheduled_time, 40ms);
+  });
+}
+
+TEST_CASE("Scheduler constructs callbacks in place") {
+  struct pinned {
+    std::atomic<int> *counter;
+    explicit pinned(std::atomic<int> *target) : counter(target) {}
+    pinned(const pinned &) = delete;
+    pinned(pinned &&) = delete;
+    pinned &operator=(const pinned &) = delete;
+    pinned &operator=(pinned &&) = delete;
+    ~pinned() = default;
+    void operator()() { ++*counter; }
+  };
+
+  harness::run([](auto backend) {
+    harness::scheduler<decltype(backend)> scheduler;
+    std::atomic<int> calls{0};
+    scheduler.template emplace_timer<pinned>(50ms, {}, &calls);
+    harness::elapse(125ms);
+    CHECK_EQ(calls, 2);
+  });
+}
+
+TEST_CASE("Scheduler drops timers whose owner has been destroyed") {
+  struct widget {
+    std::atomic<int> *ticks;
+    void on_tick() { ++*ticks; }
+  };
+
+  harness::run([](auto backend) {
+    harness::scheduler<decltype(backend)> scheduler;
+    std::atomic<int> ticks{0};
+    auto owner = std::make_shared<widget>(widget{&ticks});
+
+    dp::timer_options options{};
+    options.lifetime = owner;
+    scheduler.add_timer(dp::bind_member<&widget::on_tick>(*owner), 30ms, options);
+    harness::elapse(75ms);
+    CHECK_EQ(ticks, 2);
+
+    // no remove_timer() needed, the timer is dropped the next time it falls due
+    owner.reset();
+    harness::elapse(60ms);
+    CHECK_EQ(ticks, 2);
+    CHECK_EQ(scheduler.size(), 0U);
+    CHECK_EQ(scheduler.stats().expired, 1U);
+  });
+}
+
+TEST_CASE("Scheduler defers grouped timers over their CPU budget") {
+  harness::run([](auto backend) {
+    harness::scheduler<decltype(backend)> scheduler;
+    const auto group = scheduler.add_group({200ms, 10ms});
+    std::atomic<int> background{0};
+    std::atomic<int> critical{0};
+
+    dp::timer_options background_options{};
+    background_options.priority = dp::priority::low;
+    background_options.group = group;
+    scheduler.add_timer(
+        [&]() {
+          ++background;
+          // burn 5ms of CPU, so two ticks use up the budget of a period
+          const auto until = dp::details::thread_cpu_time() + 5ms;
+          while (dp::details::thread_cpu_time() < until) {
+          }
+        },
+        10ms, background_options);
+
+    dp::timer_options critical_options{};
+    critical_options.priority = dp::priority::critical;
+    critical_options.group = group;
+    scheduler.add_timer([&]() { ++critical; }, 20ms, critical_options);
+
+    harness::elapse(410ms);
+    const auto usage = scheduler.group_usage(group);
+
+    // without the budget the background timer would run ~40 times, with it two or three
+    // times per period
+    CHECK_GE(background, 4);
+    CHECK_LE(background, 9);
+    CHECK_GT(usage.deferred, 0U);
+    CHECK_GE(usage.cpu_time, 20ms);
+    // wall time is read from the scheduler's clock, which a tick does not advance when simulated
+    CHECK_EQ(usage.wall_time > 0ns, harness::realtime());
+    // critical timers are never deferred
+    CHECK_GE(critical, 15);
+  });
+}
+
+TEST_CASE("Scheduler rejects groups without a positive period") {
+  dp::scheduler scheduler;
+  CHECK_THROWS_AS(scheduler.add_group({0ms, 10ms}), std::invalid_argument);
+  CHECK_THROWS_AS(scheduler.add_group({-1s, 10ms}), std::invalid_argument);
+  CHECK_THROWS_AS(scheduler.add_group({1s, -1ms}), std::invalid_argument);
+  CHECK_NE(scheduler.add_group({1s, 0ms}), 0U);
+}
+
+TEST_CASE("Scheduler rejects timers with a negative interval") {
+  dp::scheduler scheduler;
+  CHECK_THROWS_AS(scheduler.add_timer([]() {}, -1ms), std::invalid_argument);
+  CHECK_THROWS_AS(scheduler.emplace_timer<std::function<void()>>(-1s, {}, []() {}),
+                  std::invalid_argument);
+  CHECK_EQ(scheduler.size(), 0U);
+  // zero still registers a dormant timer
+  CHECK_NE(scheduler.add_timer([]() {}, 0ms), 0U);
+  CHECK_EQ(scheduler.size(), 1U);
+}
+
+TEST_CASE("Polling scheduler runs due timers on the calling thread") {
+  dp::scheduler_options options;
+  options.polling = true;
+  dp::scheduler scheduler(options);
+  const auto caller = std::this_thread::get_id();
+  std::vector<int> order;
+  auto on_caller = true;
+
+  // long intervals, so real time passing during the test does not matter
+  const auto start = dp::scheduler::clock_type::now();
+  dp::timer_options low;
+  low.priority = dp::priority::low;
+  scheduler.add_timer(
+      [&]() {
+        order.push_back(2);
+        on_caller = on_caller && std::this_thread::get_id() == caller;
+      },
+      1s, low);
+  dp::timer_options critical;
+  critical.priority = dp::priority::critical;
+  scheduler.add_timer([&]() { order.push_back(1); }, 1s, critical);
+  const auto later = scheduler.add_timer([&]() { order.push_back(3); }, 2s);
+
+  // nothing is due before the first deadline
+  CHECK_EQ(scheduler.poll(), 0U);
+  CHECK_EQ(scheduler.run_due(start + 500ms), 0U);
+  CHECK(order.empty());
+
+  // due timers run in priority order on the calling thread
+  CHECK_EQ(scheduler.run_due(start + 1500ms), 2U);
+  CHECK((order == std::vector<int>{1, 2}));
+  CHECK(on_caller);
+
+  CHECK(scheduler.remove_timer(later));
+  CHECK_EQ(scheduler.run_due(start + 2500ms), 2U);
+  CHECK((order == std::vector<int>{1, 2, 1, 2}));
+  CHECK_EQ(scheduler.run_due(start + 2500ms), 0U);
+  // there is no dispatcher thread
+  CHECK_EQ(scheduler.stats().wakeups, 0U);
+}
+
+TEST_CASE("Polling scheduler notices timers added from other threads") {
+  dp::scheduler_options options;
+  options.polling = true;
+  dp::scheduler scheduler(options);
+  std::atomic<int> calls{0};
+  dp::timer_id self{0};
+
+  std::thread([&]() {
+    self = scheduler.add_timer(
+        [&]() {
+          ++calls;
+          // a callback may remove its own timer while being polled
+          scheduler.remove_timer(self);
+        },
+        5ms);
+  }).join();
+
+  const auto deadline = std::chrono::steady_clock::now() + 1s;
+  while (calls == 0 && std::chrono::steady_clock::now() < deadline) scheduler.poll();
+  CHECK_EQ(calls, 1);
+  CHECK_EQ(scheduler.size(), 0U);
+}
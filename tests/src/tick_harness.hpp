@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <periodic_function/backends.hpp>
+#include <periodic_function/periodic_function.hpp>
+#include <periodic_function/scheduler.hpp>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Tick-accurate timing harness for the tests.
+ * @details Timers under test run on dp::backends::simulated_backend by default, so time only
+ * moves when a test calls elapse() and tick counts and timestamps are exact. Passing --realtime
+ * to the test binary runs the same tests on the default backend and real time instead, for
+ * validating timing on actual hardware; the thresholds given to limit() apply only then.
+ */
+namespace harness {
+  using clock_type = std::chrono::steady_clock;
+  using duration = clock_type::duration;
+  using time_point = clock_type::time_point;
+
+  /// @brief Set by the test main from the --realtime flag.
+  inline bool &realtime() noexcept {
+    static bool enabled = false;
+    return enabled;
+  }
+
+  template <typename Backend> struct backend_tag {
+    using type = Backend;
+  };
+
+  /**
+   * @brief Timer type running on the backend selected by run().
+   */
+  template <typename Tag, typename Callback = std::function<void(const dp::tick_info &)>,
+            typename MissedIntervalPolicy = dp::policies::schedule_next_missed_interval_policy,
+            typename ErrorPolicy = dp::policies::ignore_errors_policy>
+  using timer = dp::periodic_function<Callback, MissedIntervalPolicy, ErrorPolicy,
+                                      typename Tag::type>;
+
+  /**
+   * @brief Run @p test with the backend tag of the current mode.
+   * @details @p test is a generic callable taking the tag; use it with harness::timer.
+   */
+  template <typename Test> void run(Test &&test) {
+    if (realtime()) {
+      std::forward<Test>(test)(backend_tag<dp::backends::condition_variable_backend>{});
+    } else {
+      std::forward<Test>(test)(backend_tag<dp::backends::simulated_backend>{});
+    }
+  }
+
+  /**
+   * @brief Scheduler whose dispatcher runs on the backend selected by run().
+   */
+  template <typename Tag> using scheduler = dp::basic_scheduler<typename Tag::type>;
+
+  /**
+   * @brief Timer with the callback type that CTAD deduces for @p Deduced, running on the backend
+   * selected by run(), e.g. <tt>timer_like<Tag, decltype(dp::periodic_function(f, 1s))></tt>.
+   */
+  template <typename Tag, typename Deduced> struct timer_like_impl;
+  template <typename Tag, typename Callback, typename... Policies>
+  struct timer_like_impl<Tag, dp::periodic_function<Callback, Policies...>> {
+    using type = timer<Tag, Callback>;
+  };
+  template <typename Tag, typename Deduced> using timer_like =
+      typename timer_like_impl<Tag, Deduced>::type;
+
+  /**
+   * @brief The current time of the timers under test.
+   */
+  inline time_point now() noexcept {
+    return realtime() ? clock_type::now() : dp::simulated_clock::now();
+  }
+
+  /**
+   * @brief Let @p amount of time pass for the timers under test.
+   * @details In simulated mode every tick due within @p amount has run when this returns.
+   */
+  inline void elapse(const duration &amount) {
+    if (realtime()) {
+      std::this_thread::sleep_for(amount);
+    } else {
+      dp::simulated_clock::advance(amount);
+    }
+  }
+
+  /**
+   * @brief Allowed deviation: zero in simulated mode, @p realtime_limit in realtime mode.
+   */
+  inline duration limit(const duration &realtime_limit) noexcept {
+    return realtime() ? realtime_limit : duration::zero();
+  }
+
+  /**
+   * @brief Summary of a set of timing samples.
+   */
+  struct distribution {
+    std::size_t count{0};
+    duration min{};
+    duration max{};
+    duration mean{};
+
+    /// @brief Nearest rank percentile (0-100) of the samples.
+    [[nodiscard]] duration percentile(double percent) const {
+      if (sorted.empty()) return duration::zero();
+      const auto rank = static_cast<std::size_t>(
+          std::clamp(percent, 0.0, 100.0) / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+      return sorted[rank];
+    }
+
+    std::vector<duration> sorted{};
+  };
+
+  inline distribution summarize(std::vector<duration> samples) {
+    distribution result{};
+    if (samples.empty()) return result;
+    std::sort(samples.begin(), samples.end());
+    result.count = samples.size();
+    result.min = samples.front();
+    result.max = samples.back();
+    duration sum{};
+    for (const auto &sample : samples) sum += sample;
+    result.mean = sum / static_cast<duration::rep>(samples.size());
+    result.sorted = std::move(samples);
+    return result;
+  }
+
+  struct jitter_stats {
+    /// @brief |time between consecutive ticks - nominal interval|
+    distribution period_error{};
+    /// @brief Tick start - scheduled time.
+    distribution lateness{};
+  };
+
+  /**
+   * @brief Records tick info into a buffer allocated up front, so recording from the timer
+   * thread never allocates or locks.
+   * @details Single writer: only the timer thread may record. Read the ticks after stopping the
+   * timer (or once elapse() returned, in simulated mode). Ticks beyond the capacity are counted
+   * as dropped.
+   */
+  class tick_recorder {
+  public:
+    explicit tick_recorder(std::size_t capacity) : ticks_(capacity) {}
+
+    void record(const dp::tick_info &info) noexcept {
+      const auto index = size_.load(std::memory_order_relaxed);
+      if (index == ticks_.size()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      ticks_[index] = info;
+      size_.store(index + 1, std::memory_order_release);
+    }
+
+    void operator()(const dp::tick_info &info) noexcept { record(info); }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+      return size_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] std::uint64_t dropped() const noexcept {
+      return dropped_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] const dp::tick_info &operator[](std::size_t index) const noexcept {
+      return ticks_[index];
+    }
+
+    [[nodiscard]] jitter_stats jitter(const duration &interval) const {
+      const auto count = size();
+      std::vector<duration> period_error;
+      std::vector<duration> lateness;
+      period_error.reserve(count);
+      lateness.reserve(count);
+      for (std::size_t i = 0; i < count; ++i) {
+        lateness.push_back(ticks_[i].start_time - ticks_[i].scheduled_time);
+        if (i == 0) continue;
+        const auto period = ticks_[i].start_time - ticks_[i - 1].start_time;
+        period_error.push_back(period > interval ? period - interval : interval - period);
+      }
+      return {summarize(std::move(period_error)), summarize(std::move(lateness))};
+    }
+
+  private:
+    std::vector<dp::tick_info> ticks_;
+    std::atomic<std::size_t> size_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+  };
+}  // namespace harness